@@ -1,13 +1,68 @@
+import argparse
+import os
+import shlex
+
 import m5
 from m5.objects import *
 from m5.params import *
+from m5.util import convert
 from gem5.components.cachehierarchies.classic.caches.l1dcache import L1DCache
 from gem5.components.cachehierarchies.classic.caches.l1icache import L1ICache
 from gem5.components.cachehierarchies.classic.caches.l2cache import L2Cache
 from gem5.isas import ISA
 
+from sampling import SmartsSampler
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--binary",
+                    default=os.path.join(os.path.dirname(__file__),
+                                         "../workload/gemm_pthread.out"),
+                    help="statically linked RV32 pthread program")
+parser.add_argument("--options", default="",
+                    help="arguments of the program, e.g. \"-t 16 -m 256\"")
+parser.add_argument("--harts", type=int, default=9,
+                    help="cpu core number")
+parser.add_argument("--roi-threads", type=int, default=None,
+                    help="threads that mark the ROI, default harts - 1")
+parser.add_argument("--l2-size", default="2MiB")
+parser.add_argument("--placement", default="first_free",
+                    choices=["first_free", "round_robin", "cluster"])
+parser.add_argument("--harts-per-cluster", type=int, default=0)
+parser.add_argument("--cpu-type", default="o3",
+                    choices=["o3", "minor", "timing"])
+parser.add_argument("--l2xbar-latency", type=int, default=1,
+                    help="forward latency of the L1-L2 crossbar in cycles")
+parser.add_argument("--membus-latency", type=int, default=1,
+                    help="frontend and response latency of the memory bus")
+parser.add_argument("--packet-pool", action="store_true",
+                    help="allocate packets and requests from per-thread slabs")
+parser.add_argument("--eventq-scheduler", default="list",
+                    choices=["list", "calendar"],
+                    help="event queue backend, calendar is O(1) per event")
+parser.add_argument("--sample-period", type=int, default=0,
+                    help="SMARTS sampling: instructions of all harts per "
+                         "sampling unit, 0 simulates everything in detail")
+parser.add_argument("--sample-warmup", type=int, default=20000,
+                    help="detailed warm-up instructions before each unit")
+parser.add_argument("--sample-insts", type=int, default=10000,
+                    help="instructions measured in detail per unit")
+parser.add_argument("--sample-step", type=int, default=500,
+                    help="cycles between instruction count checks")
+parser.add_argument("--sample-confidence", type=float, default=0.997,
+                    help="confidence level of the reported CPI interval")
+parser.add_argument("--sample-units", type=int, default=0,
+                    help="stop after this many units, 0 runs to the end")
+args = parser.parse_args()
+if (args.sample_period and
+        args.sample_period <= args.sample_warmup + args.sample_insts):
+    parser.error("--sample-period must exceed --sample-warmup + "
+                 "--sample-insts")
+
 # cpu core number
-num_harts = 9
+num_harts = args.harts
+
+# cpu clock, also the cycle of the sampling intervals
+clock = "1GHz"
 
 system = System()
 
@@ -16,20 +71,31 @@ system.derived_clk_domain = DerivedClockDomain(
   clk_domain = system.clk_domain,
   clk_divider = 1
 )
-system.clk_domain.clock = "1GHz"
+system.clk_domain.clock = clock
 system.clk_domain.voltage_domain = VoltageDomain()
 
-# maximum physical range for 32-bit machine
-system.mem_mode = "timing"
+# maximum physical range for 32-bit machine; sampling starts fast-forwarding
+# with atomic accesses and switchCpus changes the mode for the detailed units
+system.mem_mode = "atomic" if args.sample_period else "timing"
 system.mem_ranges = [AddrRange("16GiB")]
 
-# O3CPU cores with 2 ld/st pipeline
-harts = [
-  RiscvO3CPU(
+# O3CPU cores with 2 ld/st pipeline, or in-order Minor / TimingSimple cores
+def make_hart():
+  if args.cpu_type == "minor":
+    return RiscvMinorCPU()
+  if args.cpu_type == "timing":
+    return RiscvTimingSimpleCPU()
+  return RiscvO3CPU(
     cacheStorePorts = 2,
     cacheLoadPorts  = 2
-  ) for i in range(num_harts)
-]
+  )
+
+# 抽样时 system.cpu 是快进用的 AtomicSimpleCPU，详细 CPU 在 system.detail_cpu 中，
+# 开始时处于 switched_out 状态
+if args.sample_period:
+  harts = [RiscvAtomicSimpleCPU(cpu_id = i) for i in range(num_harts)]
+else:
+  harts = [make_hart() for i in range(num_harts)]
 
 l1icache = [
   L1ICache(
@@ -48,7 +114,7 @@ l1dcache = [
 l2crossbar = L2XBar()
 
 l2cache = L2Cache(
-  size = "2MiB",
+  size = args.l2_size,
   assoc = 4
 )
 
@@ -68,13 +134,13 @@ for (i, hart, l1i, l1d) in zip([i for i in range(num_harts)], system.cpu, system
     l1d.mem_side = system.l2crossbar.cpu_side_ports
 
 system.l2crossbar.mem_side_ports = system.l2cache.cpu_side
-system.l2crossbar.forward_latency = 1
+system.l2crossbar.forward_latency = args.l2xbar_latency
 
 system.membus = SystemXBar()
 system.membus.width = 64
-system.membus.frontend_latency = 1
+system.membus.frontend_latency = args.membus_latency
 system.membus.forward_latency = 0
-system.membus.response_latency = 1 
+system.membus.response_latency = args.membus_latency
 system.membus.clk_domain = system.derived_clk_domain
 system.membus.cpu_side_ports = system.l2cache.mem_side
 
@@ -87,20 +153,31 @@ system.system_port = system.membus.cpu_side_ports
 
 # workload and SE simulation mode configs
 thispath = os.path.dirname(os.path.realpath(__file__))
-binary = os.path.join(
-    "/home/lishunan/gemm/workload/gemm_pthread.out"
-)
+binary = args.binary
 
 system.workload = RiscvSeWorkload.RiscvSEWorkload.init_compatible(binary)
 system.redirect_paths = [RedirectPath(app_path="/lib", host_paths="/opt/riscv/sysroot/lib")]
 
 system.num_work_ids = num_harts
 
+# 每个工作线程用 m5 work_begin/work_end 标记计算区间；第一个 begin 时清零统计，
+# 最后一个 end 时输出统计，system.roi.* 中给出每个 hart 的周期分解
+# 抽样时每个单元自己清零和 dump 统计，ROI 只记录 system.roi.*，不再清零和 dump
+system.roi_stats = not args.sample_period
+system.roi_threads = (args.roi_threads if args.roi_threads is not None
+                      else num_harts - 1)
+
+# clone 为新线程挑选 hart 的策略：first_free 取第一个空闲 hart，round_robin 从上次
+# 放置的 hart 之后轮转，cluster 优先放在父线程所在的簇（每簇 harts_per_cluster 个
+# hart）。sched_setaffinity 设置的掩码由子线程继承，放置时只考虑掩码内的 hart
+system.thread_placement = args.placement
+system.harts_per_cluster = args.harts_per_cluster
+
 #process = Process()
 #process.cmd = [binary]
 
 main_process = Process()
-main_process.cmd = [binary]
+main_process.cmd = [binary] + shlex.split(args.options)
 main_process.executable = binary
 main_process.pid = 100
 main_process.pgid = 100
@@ -122,10 +199,35 @@ for i in range(1, num_harts):
   #print(system.cpu[i].ArchISA)
   system.cpu[i].ArchISA.enable_rvv = False # disable the vector extension
 
-root = Root(full_system=False, system=system)
+if args.sample_period:
+  # the detailed harts take over the threads, ports and interrupt
+  # controllers of the atomic harts in switchCpus
+  system.detail_cpu = [make_hart() for i in range(num_harts)]
+  for (i, fast, detail) in zip(range(num_harts), system.cpu, system.detail_cpu):
+    detail.switched_out = True
+    detail.cpu_id = i
+    detail.numThreads = 1
+    detail.workload = fast.workload
+    detail.isa = fast.isa
+    detail.createThreads()
+
+root = Root(full_system=False, system=system, packet_pool=args.packet_pool,
+            eventq_scheduler=args.eventq_scheduler)
 m5.instantiate()
 
 print(f"Beginning simulation! -----------------------------------------------\n")
-exit_event = m5.simulate()
-print(f"Exiting @ tick {m5.curTick()} because {exit_event.getCause()}")
+if args.sample_period:
+  sampler = SmartsSampler(
+    system, system.cpu, system.detail_cpu, args.sample_period,
+    args.sample_warmup, args.sample_insts, args.sample_step,
+    m5.ticks.fromSeconds(convert.anyToLatency(clock)),
+    args.sample_confidence)
+  exit_event = sampler.run(args.sample_units)
+  sampler.report()
+else:
+  exit_event = m5.simulate()
+if exit_event:
+  print(f"Exiting @ tick {m5.curTick()} because {exit_event.getCause()}")
+else:
+  print(f"Stopped @ tick {m5.curTick()} after {args.sample_units} unit(s)")
 print(f"\nSimulation at an end. -----------------------------------------------\n")
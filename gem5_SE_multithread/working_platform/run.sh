@@ -1 +1,3 @@
- ~/gem5/build/RISCV/gem5.opt --debug-flags=SyscallAll ./gem5_config.py > run.log
+# 在本目录下运行，--binary 默认是 ../workload/gemm_pthread.out，其余参数原样传给 gem5_config.py
+cd "$(dirname "$0")" || exit 1
+ ~/gem5/build/RISCV/gem5.opt ./gem5_config.py "$@" > run.log
@@ -0,0 +1,143 @@
+# SMARTS 式的系统抽样：快进与详细模拟交替，由 gem5_config.py --sample-period 启用
+#
+# 每个抽样周期 period 条指令（所有 hart 之和）：
+#   1. 快进：AtomicSimpleCPU 执行 period - warmup - insts 条指令。原子访存照常
+#      经过 L1/L2，缓存的标签和替换状态一直是热的（functional warming）
+#   2. 用 m5.switchCpus 切换到详细 CPU，先执行 warmup 条指令预热流水线和分支
+#      预测器，再清零统计，测量 insts 条指令后 dump，stats.txt 中每个单元一次 dump
+#   3. 切回 AtomicSimpleCPU，进入下一个周期
+#
+# 指令数按所有 hart 的 totalInsts() 之和计算，挂起或停止的 hart 不计入，所以多线程
+# 程序的每个单元测的是整机吞吐。详细模式每 step 个周期检查一次指令数，单元的实际
+# 长度以检查点上读到的指令数和周期数为准。各单元 CPI 的均值和置信区间由 report()
+# 输出并写入 <outdir>/sampling.json。
+
+import json
+import math
+import os
+import statistics
+
+import m5
+
+LIMIT_CAUSE = "simulate() limit reached"
+
+
+class SmartsSampler:
+    def __init__(self, system, fast_cpus, detail_cpus, period, warmup,
+                 insts, step, cycle_ticks, confidence=0.997):
+        if warmup < 0 or insts <= 0 or period <= warmup + insts:
+            raise ValueError("the sampling period must be longer than the "
+                             "detailed warm-up and measurement")
+        if step <= 0:
+            raise ValueError("the sampling step must be positive")
+
+        self._system = system
+        self._fast_cpus = fast_cpus
+        self._detail_cpus = detail_cpus
+        self._period = period
+        self._warmup = warmup
+        self._insts = insts
+        self._step = step
+        self._cycle_ticks = cycle_ticks
+        self._confidence = confidence
+        # 每个单元的 (指令数, 周期数)
+        self.units = []
+
+    def _total_insts(self, cpus):
+        return sum(cpu.totalInsts() for cpu in cpus)
+
+    def _run_insts(self, cpus, insts):
+        """Simulate until cpus commit insts more instructions. Returns the
+        exit event if the simulation ended for another reason, None
+        otherwise."""
+        start = self._total_insts(cpus)
+        done = 0
+        while done < insts:
+            step = self._step
+            if cpus is self._fast_cpus:
+                # 原子 CPU 每个 hart 每周期约一条指令，按剩余指令数放大步长
+                step = max(step, (insts - done) // len(cpus))
+            event = m5.simulate(step * self._cycle_ticks)
+            if event.getCause() != LIMIT_CAUSE:
+                return event
+            done = self._total_insts(cpus) - start
+        return None
+
+    def _switch(self, old_cpus, new_cpus):
+        m5.switchCpus(self._system, list(zip(old_cpus, new_cpus)),
+                      verbose=False)
+
+    def run(self, max_units=0):
+        """Sample until the program exits or max_units units (0 for no
+        limit) have been measured. Returns the exit event, None when
+        stopped after max_units."""
+        fast_forward = self._period - self._warmup - self._insts
+        while not max_units or len(self.units) < max_units:
+            event = self._run_insts(self._fast_cpus, fast_forward)
+            if event:
+                return event
+
+            self._switch(self._fast_cpus, self._detail_cpus)
+            event = self._run_insts(self._detail_cpus, self._warmup)
+            if event:
+                return event
+
+            m5.stats.reset()
+            insts = self._total_insts(self._detail_cpus)
+            tick = m5.curTick()
+            event = self._run_insts(self._detail_cpus, self._insts)
+            insts = self._total_insts(self._detail_cpus) - insts
+            cycles = (m5.curTick() - tick) / self._cycle_ticks
+            m5.stats.dump()
+            # 程序在单元中途退出时，不完整的单元不计入
+            if event:
+                return event
+            self.units.append((insts, cycles))
+
+            self._switch(self._detail_cpus, self._fast_cpus)
+        return None
+
+    def summary(self, error=0.03):
+        """CPI of the measured units with its confidence interval, and the
+        number of units needed for a relative error of error."""
+        cpis = [cycles / insts for insts, cycles in self.units if insts]
+        result = {"units": len(cpis), "confidence": self._confidence,
+                  "period": self._period, "warmup": self._warmup,
+                  "insts": self._insts}
+        if not cpis:
+            return result
+
+        cpi = statistics.fmean(cpis)
+        result["cpi"] = cpi
+        result["ipc"] = 1 / cpi
+        if len(cpis) < 2:
+            return result
+
+        z = statistics.NormalDist().inv_cdf((1 + self._confidence) / 2)
+        stdev = statistics.stdev(cpis)
+        half = z * stdev / math.sqrt(len(cpis))
+        result["cpi_interval"] = [cpi - half, cpi + half]
+        result["ipc_interval"] = [1 / (cpi + half),
+                                  1 / (cpi - half) if cpi > half else None]
+        result["relative_error"] = half / cpi
+        result["units_needed"] = math.ceil((z * stdev / (error * cpi)) ** 2)
+        return result
+
+    def report(self, error=0.03):
+        result = self.summary(error)
+        path = os.path.join(m5.options.outdir, "sampling.json")
+        with open(path, "w") as f:
+            json.dump(result, f, indent=2)
+
+        print(f"Sampling: {result['units']} unit(s) of {self._insts} "
+              f"instructions every {self._period}")
+        if "cpi_interval" in result:
+            print(f"  CPI {result['cpi']:.4f} +- "
+                  f"{result['relative_error']:.2%}, IPC {result['ipc']:.4f} "
+                  f"at {self._confidence:.1%} confidence")
+            print(f"  {result['units_needed']} unit(s) needed for "
+                  f"+-{error:.0%}")
+        elif "cpi" in result:
+            print(f"  CPI {result['cpi']:.4f}, IPC {result['ipc']:.4f}, "
+                  f"too few units for a confidence interval")
+        return result
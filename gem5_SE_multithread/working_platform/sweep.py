@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+# 多核扩展性实验：在 gem5_config.py 上扫描 hart 数、L2 容量、crossbar 延迟和 CPU 类型
+#
+# 用普通 python3 运行（不是 gem5 配置脚本）。每个参数组合启动一个 gem5 进程，
+# 最多 -j 个同时运行，输出目录为 <outdir>/<点名>。程序在每个 hart 上运行一个线程，
+# 统计取 ROI 结束时的第一次 dump（见 README 中的 system.roi.*），汇总为一张表：
+#
+#   python3 sweep.py --gem5 ~/gem5/build/RISCV/gem5.opt \
+#       --binary ../workload/gemm_param.out --options "-t {harts} -m 256" \
+#       --harts 1 2 4 8 --l2-sizes 512KiB 2MiB -j 8 --out sweep.csv
+#
+#   speedup    同一 (l2_size, 延迟, cpu_type) 中 hart 数最少的点的 roi_ticks / 本点的
+#              roi_ticks
+#   ipc        所有 hart 提交的指令数 / ROI 周期数，即整体吞吐
+#   l2_mpki    L2 缺失数 * 1000 / 提交的指令数
+#
+# 已有 stats.txt 的点不会重跑（--rerun 强制重跑），--format 选择 csv 或 json。
+
+import argparse
+import concurrent.futures
+import csv
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--gem5",
+                    default=os.path.expanduser("~/gem5/build/RISCV/gem5.opt"))
+parser.add_argument("--config", default=os.path.join(here, "gem5_config.py"))
+parser.add_argument("--binary",
+                    default=os.path.join(here, "../workload/gemm_param.out"))
+parser.add_argument("--options", default="-t {harts}",
+                    help="program arguments, {harts} is replaced by the "
+                         "hart count of the point")
+parser.add_argument("--harts", type=int, nargs="+", default=[1, 2, 4, 8])
+parser.add_argument("--l2-sizes", nargs="+", default=["2MiB"])
+parser.add_argument("--l2xbar-latencies", type=int, nargs="+", default=[1])
+parser.add_argument("--membus-latencies", type=int, nargs="+", default=[1])
+parser.add_argument("--cpu-types", nargs="+", default=["o3"],
+                    choices=["o3", "minor", "timing"])
+parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+                    help="gem5 processes running at the same time")
+parser.add_argument("--outdir", default="m5out/sweep",
+                    help="parent of the per-point gem5 output directories")
+parser.add_argument("--rerun", action="store_true",
+                    help="run points that already have a stats.txt again")
+parser.add_argument("--format", default="csv", choices=["csv", "json"])
+parser.add_argument("--out", default="-", help="output file, - for stdout")
+args = parser.parse_args()
+
+# stats.txt 中一次 dump 的开头；ROI 结束时的 dump 排在最前
+DUMP_BEGIN = "---------- Begin Simulation Statistics ----------"
+STAT_LINE = re.compile(r"^(\S+)\s+(-?[\d.]+|nan|inf)\b", re.M)
+# 只有一个 cpu 时 gem5 不加下标（system.cpu），多个时为 system.cpu0 ...
+CPU_INSTS = re.compile(r"^system\.cpu\d*\.commitStats0\.numInsts$")
+
+
+def point_name(p):
+    return (f"{p['cpu_type']}_h{p['harts']}_l2{p['l2_size']}"
+            f"_x{p['l2xbar_latency']}_m{p['membus_latency']}")
+
+
+def run_point(p):
+    outdir = os.path.join(args.outdir, point_name(p))
+    stats = os.path.join(outdir, "stats.txt")
+    if os.path.exists(stats) and not args.rerun:
+        return stats
+    os.makedirs(outdir, exist_ok=True)
+    cmd = [args.gem5, f"--outdir={outdir}", args.config,
+           "--binary", args.binary,
+           "--options", args.options.format(harts=p["harts"]),
+           "--harts", str(p["harts"]),
+           "--roi-threads", str(p["harts"]),
+           "--l2-size", p["l2_size"],
+           "--l2xbar-latency", str(p["l2xbar_latency"]),
+           "--membus-latency", str(p["membus_latency"]),
+           "--cpu-type", p["cpu_type"]]
+    with open(os.path.join(outdir, "run.log"), "w") as log:
+        result = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT)
+    if result.returncode != 0:
+        # 不留下半截的 stats.txt，以免下次被当作已完成
+        if os.path.exists(stats):
+            os.rename(stats, stats + ".failed")
+        raise RuntimeError(f"gem5 failed for {outdir}, see run.log")
+    return stats
+
+
+def read_roi_stats(path):
+    text = open(path).read()
+    dumps = text.split(DUMP_BEGIN)
+    if len(dumps) < 2:
+        raise RuntimeError(f"no statistics in {path}")
+    return {name: float(value)
+            for name, value in STAT_LINE.findall(dumps[1])}
+
+
+def metrics(p, stats):
+    roi_ticks = stats.get("system.roi.ticks", 0)
+    if roi_ticks <= 0:
+        raise RuntimeError(f"no ROI in the stats of {point_name(p)}, "
+                           "does the program call m5 work_begin/work_end?")
+    period = stats["system.clk_domain.clock"]
+    insts = sum(v for k, v in stats.items() if CPU_INSTS.match(k))
+    l2_misses = stats.get("system.l2cache.overallMisses::total", 0)
+    return {"roi_ticks": int(roi_ticks),
+            "roi_cycles": int(roi_ticks / period),
+            "insts": int(insts),
+            "ipc": insts * period / roi_ticks,
+            "l2_misses": int(l2_misses),
+            "l2_mpki": l2_misses * 1000 / insts if insts else 0.0,
+            "parallelism": stats.get("system.roi.parallelism", 0.0),
+            "futex_waits": int(stats.get("system.futex.waits", 0))}
+
+
+points = [dict(cpu_type=c, l2_size=l2, l2xbar_latency=x, membus_latency=m,
+               harts=h)
+          for c, l2, x, m, h in itertools.product(
+              args.cpu_types, args.l2_sizes, args.l2xbar_latencies,
+              args.membus_latencies, sorted(args.harts))]
+
+rows = []
+failed = 0
+with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+    futures = {pool.submit(run_point, p): p for p in points}
+    for future in concurrent.futures.as_completed(futures):
+        p = futures[future]
+        try:
+            rows.append(dict(p, **metrics(p, read_roi_stats(future.result()))))
+            print(f"done   {point_name(p)}", file=sys.stderr)
+        except Exception as e:
+            failed += 1
+            print(f"FAILED {point_name(p)}: {e}", file=sys.stderr)
+
+# 加速比以同组参数中 hart 数最少的点为基准
+group_key = lambda r: (r["cpu_type"], r["l2_size"], r["l2xbar_latency"],
+                       r["membus_latency"])
+rows.sort(key=lambda r: group_key(r) + (r["harts"],))
+for _, group in itertools.groupby(rows, key=group_key):
+    group = list(group)
+    base = group[0]["roi_ticks"]
+    for r in group:
+        r["speedup"] = base / r["roi_ticks"]
+
+fields = ["cpu_type", "l2_size", "l2xbar_latency", "membus_latency", "harts",
+          "roi_ticks", "roi_cycles", "speedup", "insts", "ipc", "l2_misses",
+          "l2_mpki", "parallelism", "futex_waits"]
+out = sys.stdout if args.out == "-" else open(args.out, "w", newline="")
+if args.format == "json":
+    json.dump([{f: r[f] for f in fields} for r in rows], out, indent=2)
+    out.write("\n")
+else:
+    writer = csv.DictWriter(out, fieldnames=fields)
+    writer.writeheader()
+    writer.writerows(rows)
+if out is not sys.stdout:
+    out.close()
+
+if failed:
+    sys.exit(f"{failed} of {len(points)} points failed")
@@ -1 +1,3 @@
 riscv32-unknown-linux-gnu-g++ -g --verbose gemm_pthread.cpp -o gemm_pthread.out -static
+riscv32-unknown-linux-gnu-g++ -O2 gemm_param.cpp -o gemm_param.out -static -pthread
+riscv32-unknown-linux-gnu-g++ -O2 -DGEMM_FLOAT gemm_param.cpp -o gemm_param_float.out -static -pthread
@@ -0,0 +1,246 @@
+// Parameterized pthread GEMM: C (M x N) = A (M x K) * B (K x N)
+//
+// Sizes, tile size, thread count and the layout of B have build-time
+// defaults (-DGEMM_M=... etc.) and can be overridden on the command line:
+//
+//   gemm_param [-m M] [-n N] [-k K] [-b tile] [-t threads]
+//              [-l row|trans] [-s seed] [-v samples]
+//
+//   -l row     B is stored K x N row-major, the inner loop streams rows of B
+//   -l trans   B is stored transposed (N x K) as in gemm_pthread.cpp
+//   -v n       check n sampled elements of C against a serial dot product,
+//              -1 checks all of them
+//
+// The matrices are filled in the guest from a hash of (seed, index), so the
+// data do not depend on the thread count or the layout. C is split into
+// tile x tile blocks which are dealt round robin to the threads. Every
+// element accumulates its products in increasing k, so C and the printed
+// checksum are bit-identical for every thread count, tile size and layout.
+// Build with -DGEMM_FLOAT for float elements instead of int32.
+//
+// The main thread is worker 0 and creates threads - 1 more, so a run needs
+// as many harts as threads. Each worker brackets its computation with
+// m5 work_begin/work_end after a barrier; see system.roi_stats.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "m5_roi.h"
+
+#ifndef GEMM_M
+#define GEMM_M 128
+#endif
+#ifndef GEMM_N
+#define GEMM_N 128
+#endif
+#ifndef GEMM_K
+#define GEMM_K 128
+#endif
+#ifndef GEMM_TILE
+#define GEMM_TILE 16
+#endif
+#ifndef GEMM_THREADS
+#define GEMM_THREADS 8
+#endif
+#ifndef GEMM_SAMPLES
+#define GEMM_SAMPLES 64
+#endif
+
+#ifdef GEMM_FLOAT
+typedef float elem_t;
+#else
+typedef int32_t elem_t;
+#endif
+
+static int M = GEMM_M, N = GEMM_N, K = GEMM_K;
+static int tile = GEMM_TILE;
+static int num_threads = GEMM_THREADS;
+static int transposed = 0;
+static uint32_t seed = 1;
+static int samples = GEMM_SAMPLES;
+
+static elem_t *A, *B, *C;
+static pthread_barrier_t start_barrier;
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// Small values so that int32 dot products cannot overflow for K <= 1024
+static elem_t init_value(uint32_t matrix, uint32_t index) {
+    uint32_t h = hash32(seed ^ hash32(matrix * 0x9e3779b9u + index));
+    int v = (int)(h & 15) - 8;
+#ifdef GEMM_FLOAT
+    return (elem_t)v * 0.25f;
+#else
+    return v;
+#endif
+}
+
+// B(k, j) in either layout
+static inline elem_t b_at(int k, int j) {
+    return transposed ? B[(size_t)j * K + k] : B[(size_t)k * N + j];
+}
+
+static void compute_tile(int bi, int bj) {
+    int i_end = bi + tile < M ? bi + tile : M;
+    int j_end = bj + tile < N ? bj + tile : N;
+
+    for (int i = bi; i < i_end; i++)
+        memset(&C[(size_t)i * N + bj], 0, (j_end - bj) * sizeof(elem_t));
+
+    for (int bk = 0; bk < K; bk += tile) {
+        int k_end = bk + tile < K ? bk + tile : K;
+        for (int i = bi; i < i_end; i++) {
+            const elem_t *a = &A[(size_t)i * K];
+            elem_t *c = &C[(size_t)i * N];
+            if (transposed) {
+                for (int j = bj; j < j_end; j++) {
+                    const elem_t *b = &B[(size_t)j * K];
+                    elem_t sum = c[j];
+                    for (int k = bk; k < k_end; k++)
+                        sum += a[k] * b[k];
+                    c[j] = sum;
+                }
+            } else {
+                for (int k = bk; k < k_end; k++) {
+                    elem_t a_ik = a[k];
+                    const elem_t *b = &B[(size_t)k * N];
+                    for (int j = bj; j < j_end; j++)
+                        c[j] += a_ik * b[j];
+                }
+            }
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    int id = (int)(intptr_t)arg;
+
+    // Each thread fills a slice of A and B
+    size_t a_size = (size_t)M * K, b_size = (size_t)K * N;
+    for (size_t x = a_size * id / num_threads;
+         x < a_size * (id + 1) / num_threads; x++)
+        A[x] = init_value(0, x);
+    for (size_t x = b_size * id / num_threads;
+         x < b_size * (id + 1) / num_threads; x++) {
+        // hash the logical index k * N + j so both layouts hold the same B
+        size_t logical = transposed ? x % K * N + x / K : x;
+        B[x] = init_value(1, logical);
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    m5_work(1, 0, id);
+
+    int tiles_n = (N + tile - 1) / tile;
+    int num_tiles = ((M + tile - 1) / tile) * tiles_n;
+    for (int t = id; t < num_tiles; t += num_threads)
+        compute_tile(t / tiles_n * tile, t % tiles_n * tile);
+
+    m5_work(0, 0, id);
+    return NULL;
+}
+
+static uint32_t elem_bits(elem_t v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+static int check_element(int i, int j) {
+    elem_t ref = 0;
+    for (int k = 0; k < K; k++)
+        ref += A[(size_t)i * K + k] * b_at(k, j);
+    if (elem_bits(ref) == elem_bits(C[(size_t)i * N + j]))
+        return 1;
+    printf("mismatch at C[%d][%d]\n", i, j);
+    return 0;
+}
+
+static int usage(const char *prog) {
+    printf("usage: %s [-m M] [-n N] [-k K] [-b tile] [-t threads] "
+           "[-l row|trans] [-s seed] [-v samples]\n", prog);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char *opt = argv[i], *val = argv[i + 1];
+        if (!strcmp(opt, "-m"))
+            M = atoi(val);
+        else if (!strcmp(opt, "-n"))
+            N = atoi(val);
+        else if (!strcmp(opt, "-k"))
+            K = atoi(val);
+        else if (!strcmp(opt, "-b"))
+            tile = atoi(val);
+        else if (!strcmp(opt, "-t"))
+            num_threads = atoi(val);
+        else if (!strcmp(opt, "-l"))
+            transposed = !strcmp(val, "trans");
+        else if (!strcmp(opt, "-s"))
+            seed = strtoul(val, NULL, 0);
+        else if (!strcmp(opt, "-v"))
+            samples = atoi(val);
+        else
+            return usage(argv[0]);
+    }
+    if (argc % 2 == 0 || M <= 0 || N <= 0 || K <= 0 || tile <= 0 ||
+        num_threads <= 0)
+        return usage(argv[0]);
+
+    printf("gemm M=%d N=%d K=%d tile=%d threads=%d layout=%s %s\n",
+           M, N, K, tile, num_threads, transposed ? "trans" : "row",
+#ifdef GEMM_FLOAT
+           "float"
+#else
+           "int32"
+#endif
+           );
+
+    A = (elem_t *)malloc((size_t)M * K * sizeof(elem_t));
+    B = (elem_t *)malloc((size_t)K * N * sizeof(elem_t));
+    C = (elem_t *)malloc((size_t)M * N * sizeof(elem_t));
+    pthread_t *tid = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    if (!A || !B || !C || !tid) {
+        printf("out of memory\n");
+        return 1;
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, num_threads);
+    for (int i = 1; i < num_threads; i++) {
+        if (pthread_create(&tid[i], NULL, worker, (void *)(intptr_t)i)) {
+            printf("pthread_create failed for thread %d\n", i);
+            return 1;
+        }
+    }
+    worker((void *)0);
+    for (int i = 1; i < num_threads; i++)
+        pthread_join(tid[i], NULL);
+
+    uint32_t checksum = 0;
+    for (size_t x = 0; x < (size_t)M * N; x++)
+        checksum = checksum * 31 + elem_bits(C[x]);
+    printf("checksum 0x%08x\n", (unsigned)checksum);
+
+    int ok = 1;
+    if (samples < 0) {
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++)
+                ok &= check_element(i, j);
+    } else {
+        for (int s = 0; s < samples; s++) {
+            uint32_t h = hash32(seed + 0x1234 + s);
+            ok &= check_element(h % M, (h >> 16) % N);
+        }
+    }
+    printf("validation %s\n", ok ? "passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include <pthread.h>
+#include "m5_roi.h"
 //#include <stdlib.h>
 //#include <string>
 //#include <iostream>
@@ -13,12 +14,12 @@ using namespace std;
 
 pthread_t tid[num_threads];
 
-
 float A[I][K] = {-0.49541172431995384, -0.7173090468860868, -1.2056409793720346, -2.3275425868873336, -1.1263154297333697, -1.3630260507092065, -8.547590262688257, -4.46950622064965, -5.872003944315231, -4.055086183310178, -4.526984672397422, -4.190705823574454, 4.462016029821882, 2.0353412055808677, 4.537535407110909, -13.585253711508855, -11.05992296170296, -0.6805142527028755, -6.082045288910962, 1.5603717098050822, -3.3011062099297863, -4.200187235701392, -0.8738269612890361, 0.8176645914124623, -9.526095526275999, -2.2896325886402282, 11.504305940127098, -11.6441582323088, 3.802302608008641, -11.517219939861562, 2.7331620015991684, -5.229280934729035, 1.6166763706079568, -4.796523079835718, -7.863223544341808, 5.72584194653424, 5.2664549816270645, -0.35470510089113916, -2.768040393251099, -6.363539205446822, 2.052990842894714, -5.967994477208793, 0.9859691153523638, -2.6357399339031815, -4.562552350092587, 0.5123060149121672, -2.2555532784427172, -0.6392343123629416, 5.854926850866381, 2.5765922457163395, -0.9886129403107025, 0.014667203807050555, 1.5850877579248777, 9.420849238624072, 1.4330598010176891, 4.121792978506436, -1.9146217537976464, -2.134370357236122, 2.0020677265392055, -8.403015905110948, -6.745195285515823, 3.1933874539724902, -5.806583469537536, 10.218632456431084, 1.527474833311905, -5.806871487057031, -8.680957113367182, 0.8081549598045956, -5.5932559606571095, 3.892665772336156, 2.263470663564621, -5.329787585064456, 2.6147528259520634, -3.65269870972382, 3.846258857408544, 2.409988484452163, 6.8132239287909115, -2.1116276516597043, 9.530180626130774, -4.936821038218947, -7.48494448795066, -6.249612536421346, -1.026531318514287, 1.9036594101764117, 3.1822736053663974, 0.03576298053371074, -11.775203104179784, 0.44588468946956294, -7.147886815679131, 4.574368979715242, 8.351136124488464, 1.8458681129368153, -3.08007044962158, -13.162481659266529, 1.231972046750374, -4.498488329362662, 4.102714869893093, -4.893666203113879, 2.506171117911176, -7.889924418291593, -2.26275848026856, -2.724256787019299, -8.32500932869043, -0.6787819746746335, -4.225203982259703, 1.5385550932289629, 3.0135304413442974, 3.8266579541493932, 0.5025574598729017, -1.4579820420258045, -6.743895952145537, 5.165523487427916, 6.6259531279138795, 6.955372835669044, -0.30443987708207254, 5.813433394196773, -3.1201592483503022, 2.378171932351491, -4.654754783011777, -5.670405944442715, -7.498513227744459, -2.100400862152248, 2.2708916724601185, -3.1704916622224104, -3.8584565591316298, 3.688877596621955, 0.8253632074010417, -1.881524579449532, -5.314725873025779, 11.19030567912019, -2.023673980225991, -4.044686653389485, 5.765242730263341, 3.8985295427237423, -4.169188690652584, -0.40799787883063454, -2.861899964391383, -1.285772083557652, 2.7840315896110632, -5.838073472260605, -1.9823403080969326, 0.7683189893118392, -5.194507093297201, 4.149972326106611, -0.18869252599257225, -2.439767729729458, 1.2535823694965162, -14.412977976531295, 0.5955249152970439, -0.35429613253433456, -3.6643771078340377, 1.7278355079120815, 1.8493952777177145, -3.260525054096071, 3.716057189166575, -3.965596346951298, 0.4160581081925856, 2.716937418436108, -0.019528952553045764, -2.4268353555060758, -1.1435510765276828, 1.0217156780485777, 4.227539180896943, 0.7473004065211997, -4.824277054403513, 2.930381840327076, -1.3955643192015192, -3.659498806484577, -1.6953523956824075, -6.189886148236765, -1.122741206650738, 3.221072591309845, 0.6251034739018935, -8.693405447312216, -3.896431675466475, 8.865010467766652, 0.518272059487991, 3.7036757059139624, 3.505705758020734, -12.495790040177692, 1.8108243311525838, -4.708430064723911, -7.336100394676142, -2.6685847093276656, -1.6530156015938484, -1.2831727403695563, 3.628399938863213, -1.6915204371265546, -3.8727789457857784, 0.946039484362653, 1.2796907894265814, -9.16372807690753, -0.15391509947775683, -0.5340167199205937, -1.3223575139760053, 4.234160899272165, -0.7361573352556778, 4.50057451831851, -2.013031869790088, 0.5461725256644971, 2.0562262599882395, 3.148164652386548, -5.8283974554140965, 7.311648707474438, 0.44898412773200436, 3.134048929787749, 7.964362314023337, 1.2274491987245972, 2.2494138916640796, -4.526499348639177, -2.4845999849982077, -2.3920257065141404, -0.08177583689538737, 3.5885671196246625, -8.072917832579991, -1.865392746919933, -2.1072809379422597, -0.8937842023136214, -2.3747032361862166, -8.814647954771921, 5.343773838367457, -1.0719887191145052, -1.6245977461596341, -5.781134435551523, -5.531416752780138, -0.957691403915701, 5.262122128380398, -1.2540514030730083, -2.29252731440213, -0.0880879245547801, -2.0006307644132333, -0.8844519516912676, -6.855274135624646, 10.646640072749758, -5.23492631454127, -8.087750130848308, 5.8767094825383825, -2.4298766287272473, 4.29116243180313, -11.993791353776093, 2.289744314688188, -1.1285690686885361, -4.483080948634306, -0.9639510576867742, -7.732961572138258, 3.281454170124926, 1.6004872845883202, 6.69106593755935, 4.916069892492143, 0.04148898680537494, 5.922031745874988, -3.432725330971653, 3.3977181613781298, -3.19453014531906, 2.619336956528035, -0.7393464224193775, -0.8463386037733538, 0.21143579492310827, 2.618554657845914, 1.5395547581981743, 6.686972661975164, -1.0708605954915196, 4.466313543147311, -4.046846218443849, -4.122717573721413, 5.5599376376052945, 2.7573193622246652, 6.585994501945265, 3.797331422349753, 8.49841411960862, 7.465324869211543, -4.991977444892527, -1.2420338879263997, 0.5783430442838433, -1.8624183295795003, -6.875404664314772, -4.141759022000233, -4.524805568444099, 1.0319124205626595, 0.13975979073687372, -1.9306996127397875, 2.085494470918447, -1.1663062420376096, 1.5376338978024688, -3.2565497751774912, -4.786481395333867, 2.597901552570413, 4.767546922280793, -6.265580321158035, -5.785527121135357, -2.723976147150381, -4.211511711124864, 5.272553578072665, -0.2826262189462365, 0.49491505910875766, 4.936211828268726, 5.1210229371796885, -7.551665670455142, 1.7401604452048907, -2.216280317131165, 8.420877610148924, -8.738755776944101, -8.158399173938749, -0.9214391412571258, -12.26906812647677, 5.6982164586867174, 8.197907123482503, 3.900763434512351, 4.328938384183909, 4.193716115608034, -11.141120672812987, 2.0977481380943117, -6.065641282987557, -0.7269896722851323, -7.813833598736822, 5.827517356707126, -5.965023468648745, 9.827227288783725, 9.981556577037237, 1.9923933651321892, 0.25142412578592954, 0.5003451267653236, -3.2811857890006646, 3.310251563295341, -1.1935690669973846, -8.604187420792659, 0.02385359484791394, 1.7575101665384643, 1.7794118574716546, -0.45154581566779384, -4.810712534048747, 9.412189780539535, 0.9672496078495136, 10.413096582666789, -13.62027271990032, -2.2804840523595105, 11.646729216248929, 2.5306463866532884, 5.244527318951903, 3.786103492969332, -1.4992908875848958, -10.636320974134716, -2.2697710424152726, -6.12918991141874, -4.948196969865778, 4.986341194000597, 1.9352473354965531, -8.669139670164341, -4.082351953327673, -9.90372123147282, -4.827084221550233, -7.844322371577494, -0.46090375271506856, -2.0677915982465835, -1.0431063674026428, -1.9532701697316281, -8.567072212023993, 9.912569189562673, -2.6984898480294546, 6.787849370780929, 2.5803240407033243, -2.175237152358852, 1.9368357438403647, -2.3131214407318663, -3.439211498217148, 0.8759633333665904, -4.095979868572098, -3.0707952462228136, -9.942305986535255, -7.927387601750139, -7.248312540490567, -4.972326124994119, 2.111224842315308, 2.283811392181235, -0.003992686151575109, -2.357873623760233, 4.088780884770671, -7.13143482395485, -4.0622953913276625, -7.0369239209560055, 0.984532894071029, -7.936477023811232, 8.376457030027932, -1.2392633148949956, -3.093800199362163, 3.8231088295591897, -4.698885923891529, -8.516019593272, 1.2072779156222282, 1.1030158599693491, -3.7602711723020357, -4.935970691473995, -2.94177846025202, -4.881618411874218, -5.31693405466498, -1.0292396228644864, 6.616241898413517, -9.006941263243839, 0.8627167669314535, -2.131946230713547, -3.757107281237957, 0.901258576088146, 2.562943796302683, -9.115943399449156, -6.890686498626383, -1.728499289502984, -0.590343296357198, 2.2736612979519397, -6.972653865774527, -2.620076315001441, -6.664689025761637, -2.486710964290394, -3.674945407694266, -2.794522946509809, -2.140458080282091, 5.827345268408466, 4.073226043052648, 10.357993493452017, 4.792062397426969, -8.565671920500844, -1.849984323142483, -2.8971320558266056, -1.913685124391923, 5.747072548940089, 2.90180623454903, 1.8873846397447172, 8.934497642391726, -1.4143933550730488, -4.428567971300888, -5.818754335462317, 0.26209754992879364, 7.779549900819919, 0.5559563230950659, -5.15558734131582, 1.0904790854705833, 0.8352719467134806, 0.4069909878704576, -5.06478798080495, -6.066984841373201, 2.8270366847410804, 1.210263598826034, -4.148955785287844, 0.1792821495108765, 1.1714231790794996, -0.5352319091853899, -3.2441466527200484, -8.178851895872855, -1.8858877769504194, 3.936703405378494, -4.541650693909192, -1.6103902532136511, 1.670024946014553, -2.661795602593503, -4.425243722443955, -4.8959998705409316, 2.2595342362470303, -2.322246224263419, 5.376630853272447, -4.327802644174371, 7.059482520707071, -4.612914338234784, -9.576039756817439, 0.38693526618329654, -2.3828489108867847, -4.0535155957340825, 8.479836689308737, 0.3235422859050938, -7.83620902090505, 0.8844239179249236, -9.86939896863608, -6.216880436744416, 1.6528805088547545, -0.5541849113392943, -9.01039087571606, -4.909867659882134, 8.39867364936829, 0.7648879554894159, 1.2209194794224398, -6.775974134430001, -0.3321388492156615, 1.730575272927596, -0.5944850470959164, -8.278258766678906, -4.682056366659463, -1.2280554753025519, -5.34978414787543, -6.8990532438617995, -0.5284651953732242, -3.4028274427419363, -9.181379192285371, 9.831287212066433, -5.019221940590229, 0.2986282983953199, 11.539602826610958, 3.515550029480967, 3.7572618070650137, 1.7968338080166193, -5.027849582060707, -4.959248810365292, 4.012416145316884, 6.289272533364148, -0.19428629082201399, -1.6680892304376134, -3.3379038255149647, -5.86399292410367, 1.008990851591593, -1.8938939188021005, -1.0516834726273818, -7.112043307248998, 1.0202497909820698, 0.4011925290511553, 0.17002797249283952};
 float B[J][K] = {-4.613098109486007, 3.674247633121928, -0.6432601224736954, 2.528190526681289, 16.60758748981432, -3.4361001331333636, 3.145176676123698, 13.588723066958286, -0.2037274158514064, 8.572429346371203, -5.039301905809775, 3.300867793645142, -4.564864910375766, -6.238120006302742, 7.262661711692747, 6.41288443750713, 3.031225100547398, -8.956312163610809, 16.401202569982182, 17.895862696780256, 7.222429244978032, -7.542063884042671, 4.609511478449342, -6.792949495755491, 1.297449871815759, 7.244696113462809, -9.526851765074973, 15.890160624455568, 7.938422807148572, -0.15088190529183154, 8.221589157665065, 7.718030438705269, -5.971699915934715, 6.622933035481518, 1.7296045652544905, -2.9498776269546036, 0.6400833437930313, 2.9184659774752495, 1.2769296754373363, 2.176880745738495, 1.3512510626756784, 2.9103513081096337, 4.3785364312520745, 16.249051817508406, -0.40713956225588843, -1.9924039220718215, -9.452484705674104, -8.234061060457936, -7.410402829968309, 7.908064372511215, -1.7453316036330069, 15.649791757627975, -1.4790292942137544, -7.243955431017671, 16.538012916603087, -3.0096111393747096, -5.201783838092351, 11.436872004711873, -3.572175971607898, 8.796344402441637, 9.452071149447388, 10.758340438532633, 6.234399985903085, -4.006617356492354, 9.985665502586384, 19.606228002151635, 12.340666852486189, 13.772112581182617, 1.62810075004802, -8.63215117257884, -5.552424106764516, -15.03728436572176, -9.424387033035712, -2.3360381528790155, -10.472959980677242, -1.0196728723612152, -16.712706655659982, 4.07516565322554, 3.7243883988842676, -5.855345334091212, 0.7484661120229682, -4.373072048876779, -9.094699290340204, 8.137351201544506, -5.084943680037553, -3.324161653290255, -0.22390496611037358, -2.1004099694724543, 3.985143397024764, -1.0603110041286508, -2.366477563361228, 15.759306844579271, 6.900401998053579, 13.532623418603679, 9.669909302609016, 7.8084974398836025, -1.9165525373761287, 2.1019671265288573, 17.891908497993846, -9.390040806272765, -2.29134051726811, -3.443091746160291, 4.884891129968032, 8.88657786398673, -6.784221121089905, 4.132241255913195, 0.27399517423360664, -5.110675627419203, -7.666588010169081, -12.979408713628569, 4.963043600562667, -2.5946046182426494, -8.310991950915735, -5.972966125042526, 10.60328700972175, -0.27401779162229345, 0.7357244373036105, 6.246496413750605, -3.4671459689202804, -9.440892364271708, 20.46561819156806, -4.769253402299467, 4.651934225644922, -0.9477295733579645, 1.6244420285508736, 2.2418179312979447, -5.9112433221665155, -4.570465425454206, -2.3273271752839393, 3.7289046465861446, 0.652026628823652, 10.071824680216132, 0.640389538310455, -7.1655750680572226, 7.421324014137322, 14.573696902492802, 6.155285867768499, -5.067109506903927, -1.644597801650344, -2.002900516455487, -15.135237224179445, -0.5783920694859082, -8.687674081253432, -0.8394566654214213, 0.6170773755834184, -0.1511880620713999, 5.36438852724773, -4.477707178420671, -8.644836559370217, 1.9783714325756154, 0.001778145048310531, 8.484268833057598, -3.6811771162466256, -1.9049018696556685, 11.469597540758771, 2.146738098170851, -4.333192240458827, 3.087912288201713, -0.33931191079324163, 7.327119184707033, -7.250185223914142, 3.6916547146135223, 1.604168156952815, 11.045078730286523, -1.867927380617763, 5.553899460745956, 2.266932083174065, 2.4996478345896405, -1.339312534271166, 3.002462300348241, 8.21163333603642, 5.836841646825628, -0.4193169423691756, 4.897658514315817, -0.7446413894904083, -6.558124618967821, 1.3401791359592004, -0.40485856295778677, 0.5284157957758656, 2.388527410756363, -8.07920857368444, 15.797570053332176, -7.509358050326412, -9.898449355198172, 1.0769968605575126, 2.252845956580533, -1.127168039570555, 9.95919096880832, -10.868870419303796, 16.04469421300738, 5.311609228865844, 2.6632827269702664, -8.062679318769922, -5.449346718273157, 2.666372901425402, 5.043714270999503, 6.297974890618814, 8.520565605978078, -10.498405850508822, 7.201824318699384, -6.7421397238353435, 5.71862867982563, -7.1828374086868685, -4.808822321588139, -0.6161546863112908, -0.11243418921929083, 8.199782069611414, 7.7050783026272756, 10.692082161949031, -7.701193257397396, -4.217131119946215, 7.521479210178596, 5.666418920234077, -0.8550422143369822, -0.015084549779792678, 9.29515699376612, -8.272110767259218, 5.929613985747787, -6.6166575080901335, 5.72458811216813, 4.3736809989874175, 1.3391527774041565, 9.680354770357393, -5.346929763818152, 11.218865853001427, -3.1069040136435637, -3.102715870124567, 14.519349540927314, 11.009407110036022, -4.877809968830772, 5.95295291419814, -0.4750951205013463, 9.636523587774878, 0.9845832925604872, 11.799025994368701, -8.633654323382913, 0.8907557920607855, 5.612553514154155, 11.884849810808584, -2.0805473462331183, 9.553499814057712, 4.461302826215327, -0.33061699181058635, 5.455448140881808, 11.688528994143791, -9.22586829756303, -7.3989690339151775, 2.327110232293405, 4.963718017015696, -1.9912933856367219, 3.580962805169566, -0.7521583529395981, 4.992548994779515, 0.15424630109497783, 9.204810001429761, 1.5768232212090665, -1.0304190408040599, 0.9377954999536915, -4.498364610329868, 3.1701457911621143, -0.7299629350612735, -3.2620453232078166, -8.906816958059462, -8.886860997120728, 1.8621318185578257, -0.09609699177400266, 12.367563900689216, 2.7185085375942997, 2.826035555227919, 6.81494053475118, 3.8345167149037733, 6.5772335919375715, 5.252797379239075, 12.248039951841607, -1.1436650425503552, -2.2442664926488427, 7.044866442950923, 7.843803441505363, 12.308876276993107, 6.393464899764509, 6.515790741815133, 1.7871593145187428, 7.813332599198327, 6.792423137494164, 12.514803950464318, 11.980633434908508, -7.0129977246711555, 4.029776055786186, 2.8015817520822566, 7.017212717402496, 18.04486028467915, 8.762139082527154, -7.4274002976265745, -2.285603238924674, -0.971480317848447, -5.495482690960398, -0.1292738931439601, -9.765752172645344, 1.4331900958555224, -4.897893876985912, -5.380796814041225, -0.2095820862565525, 4.388432510219347, 8.015839149335644, 11.410002695809974, -6.214699901016317, 2.1553936885280724, 6.01756807259295, -8.518193076988945, -1.813080606793592, 4.163027484327949, 9.703814222066287, 2.596557679156252, -6.748349605625019, -4.2043084685379695, -6.381882284487981, -6.068312499274663, -22.16209049972959, 4.963787282727792, 2.0725129873790804, 5.769368267389714, -4.069169601678191, 1.690039325059975, -0.00013547832340288224, 5.0981906199704365, -2.7870881926429183, 7.083323766436021, 1.696161829909543, 12.039370102140634, 0.2268275589038775, 4.4948501880497895, -3.844033146768532, 18.948121780050272, 4.533262804712746, -6.947526764073513, 6.014453030298026, 10.352838946905273, 13.99408011882965, -0.11086621149397358, -2.9766357317705827, 2.3133778007256476, -15.951747363877537, 8.6862636005776, -0.9626836188614241, 7.568962317127348, 9.691051081705583, 4.29951298129532, -3.3131965975525137, 5.365595203321791, 0.7209946739621772, 11.310536888281117, -2.318355916984735, -11.27967109269012, -3.6207453967325103, -10.818714979483486, 3.7618311374183726, 5.911494120387937, -4.379100660576402, 0.1415681278710137, 2.1389551341157285, -1.4821274238510656, 2.521267722432656, 0.8369462383539158, -4.130912796085338, -4.07760250873206, 5.342132569669081, 4.070954107080228, 1.54829125090097, -3.9338792115298817, -1.4836127919606206, 1.279830069701855, 2.943711868385272, -11.012668453584308, 7.0042862516072475, -2.060209778506435, 10.676395377911854, 10.318098495165877, 5.328604071124454, -1.2577893963132412, 8.084499110788723, -17.073084008911934, 4.410153196233912, 6.647348174779103, 0.8512112188100625, 7.019558086865528, 0.24490062760967612, -0.3160396364088782, 2.9311496083832465, -7.344515652823688, -4.660179419740843, 1.8339578429535672, -4.144861334631717, -2.074625277261271, 2.0971123140876466, 10.737116866204612, 10.355121899065123, -11.967320159894065, 6.220384653937212, 0.46571629488063326, -2.9102370015464993, 5.765376078642648, -6.310888827703897, -9.625911660669779, 4.428926259076869, -7.200646168256625, -1.2976152692853868, -11.952855767783468, 5.482868943034736, 11.254779560633239, 5.010969405142018, -5.587614051802833, 6.938557158579769, 9.978160403677958, 8.86804016699166, 10.948803893551748, -5.120530712444793, 11.568556222735827, 3.2525287955511226, 5.5248935287825995, -5.385202665884931, -4.540024781401294, -1.478653183186864, 5.710735092022935, 14.22581787285773, 10.189084276730675, 0.9318365877626633, 7.283365778403515, -8.069013521318285, -12.984453413874206, 3.1201396375831916, 0.9677591268045569, -13.94573567356059, 3.8835016652495713, -5.379029479716313, 5.95757834680508, 12.966923704615917, 1.864681077915058, -8.05668069380889, 10.783299345626938, -1.3544199098234548, -5.116078339548067, -1.0491468304711677, 8.816614812608773, 3.781276110577903, -1.4432018816460204, 6.644185986774382, 7.973959072515168, 5.352606477906343, -8.707383859327098, -1.5043834735272306, 7.136708717545366, 7.766238198472392, -3.603554065852207, 0.5572339690343703, 6.135792038888593, 5.440767160007534, -2.5721804159844766, -0.16442793532492495, 5.192897806827994, 5.990478032997556, -2.86851238239919, -9.271188927308238, 11.130322929301501, 0.871899914660111, -7.404499723655961, -8.676227511594394, 13.676870457073791, 1.0315401063005056, 10.33710949524682, 4.4924745419737135, 8.467806412760197, -0.20484922498524227, 16.79488146301349, 10.290777044350648, -5.393007397977254, -1.6813579420298388, 7.105323708223114, -12.358742948600355, -2.9948508481220566, 13.359163041843631, 1.3751673438753045, -3.5525824357989144, 7.314162239287804, 3.7353688360952324, -15.914846165585487, 5.002530823266505, -5.478634752209042, -0.160588047413027, -3.183501806171419, 7.308279370201784, 3.262352097234331, -7.471043677662378, 9.495717139420648, -3.9183299195403993, -5.469101840564515, 13.29791035375671, -3.4692948770271945, 13.843128952478997, -2.33457758081752, -1.3221039630987472, 13.179668322226615, 10.46219761247407, -2.78870346657669, -10.08235727838193, -0.3610369496009953, -9.979631638180589, 4.546651943292403, 6.3789838957744225, 9.001351202891387, 6.9610317554948375, 4.859118500220778, -3.076031419359442};
 float C[I][J];
 
 void * thread_gemm (void * blk_start) {
+    m5_work(1, 0, *((int *)blk_start));
 
     for(int i = *((int *)blk_start) * I/num_threads; i<*((int *)blk_start) * I/num_threads + I/num_threads; i++) {
         for(int j = 0; j<J; j++) {
@@ -32,6 +33,8 @@ void * thread_gemm (void * blk_start) {
 
     //std::cout << "blk" + std::to_string(*((int *)blk_start)) + "computes at an end.";
 
+    m5_work(0, 0, *((int *)blk_start));
+
     //return ((void *)0);
     return NULL;
 }
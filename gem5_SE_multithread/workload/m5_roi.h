@@ -0,0 +1,22 @@
+// gem5 region-of-interest markers for the pthread workloads.
+// Each worker brackets its computation with m5_work(1, ...) / m5_work(0, ...),
+// see system.roi_stats in ../working_platform/gem5_config.py.
+#ifndef M5_ROI_H
+#define M5_ROI_H
+
+// gem5 m5 ops: opcode 0x7b with the function number in bits 31:25. On RV32
+// each 64-bit argument takes a register pair (a0/a1, a2/a3).
+static inline void m5_work(int begin, int workid, int threadid) {
+    register unsigned a0 asm("a0") = workid;
+    register unsigned a1 asm("a1") = 0;
+    register unsigned a2 asm("a2") = threadid;
+    register unsigned a3 asm("a3") = 0;
+    if (begin)
+        asm volatile (".word 0x7b | (0x5a << 25)" : "+r"(a0)
+                      : "r"(a1), "r"(a2), "r"(a3) : "memory");
+    else
+        asm volatile (".word 0x7b | (0x5b << 25)" : "+r"(a0)
+                      : "r"(a1), "r"(a2), "r"(a3) : "memory");
+}
+
+#endif // M5_ROI_H
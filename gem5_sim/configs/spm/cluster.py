@@ -0,0 +1,258 @@
+# SPM cluster template (docs/mem_hier_v0.md 1.2)
+#
+# 一个簇包含 num_cores 个核心，每个核心私有 L1I/L1D SPM，簇内共享 L2 SPM
+# 和一个 IDMA。簇内两个交叉开关：
+#   xbar1: 核心的 icache/dcache 端口 -> 各 SPM 的 port、L2 SPM、IDMA 寄存器
+#   xbar2: IDMA 的 dma 端口 -> 各 SPM 的 dma_port
+# 簇外流量经 Bridge 上行到第二层级交叉开关，其他簇经下行 Bridge 进入 xbar2，
+# Bridge 的 ranges 限定了各自转发的地址，避免两级交叉开关之间的地址环路。
+#
+# 物理地址 (真名) 位于 4GB 之外，每个簇占 16MiB 窗口：
+#   cluster_base(c) + k * 0x20000          核心 k 的 L1I SPM (64KiB)
+#   cluster_base(c) + k * 0x20000 + 0x10000 核心 k 的 L1D SPM (64KiB)
+#   cluster_base(c) + 0x100000             L2 SPM (256KiB)
+#   cluster_base(c) + 0x140000 + i * 0x1000 第 i 个 IDMA 的寄存器
+# 程序使用与 hybrid_memory.py 相同的 32 位地址，由每个进程的页表映射到
+# 本核心/本簇的 SPM，见 SpmCluster.map_process()。
+#
+# alias_decode=True 时每个核心的端口前插入 SpmAliasMapper，由硬件译码
+# 簇别名、簇中核真名和簇真名 (0x80020000 / 0x81000000 / 0x88000000)，
+# 页表对这些窗口只做恒等映射。核别名窗口仍由页表映射到真名，因为 SE 加载器
+# 把程序放在这个窗口里，需要先把内容拷到本核心的 SPM。
+#
+# 默认整个簇共享一个 IDMA，每个核心一个通道；idma_per_core=True 时每个核心
+# 有自己的 IDMA，中断只送给该核心。两种情况下程序都在 0x80060000 访问
+# "自己的" IDMA。
+
+from m5.objects import *
+
+CLUSTER_BASE = 0x1_0000_0000
+CLUSTER_STRIDE = 0x100_0000
+CORE_STRIDE = 0x2_0000
+L1_SIZE = 0x1_0000
+L2_OFFSET = 0x10_0000
+L2_SIZE = 0x4_0000
+MAX_CORES = L2_OFFSET // CORE_STRIDE
+
+# 程序看到的地址，与 spm_test 及 hybrid_memory.py 一致
+L1I_VADDR = 0x80000000
+L1D_VADDR = 0x80010000
+L2_VADDR = 0x80020000
+IDMA_VADDR = 0x80060000
+IDMA_OFFSET = 0x14_0000
+IDMA_SIZE = 0x1000
+# SpmAliasMapper 默认的别名窗口
+CLUSTER_ALIAS = 0x81000000
+GLOBAL_ALIAS = 0x88000000
+
+
+def cluster_base(cluster):
+    return CLUSTER_BASE + cluster * CLUSTER_STRIDE
+
+
+def cluster_range(cluster):
+    return AddrRange(start=cluster_base(cluster), size=CLUSTER_STRIDE)
+
+
+def l1i_base(cluster, core):
+    return cluster_base(cluster) + core * CORE_STRIDE
+
+
+def l1d_base(cluster, core):
+    return l1i_base(cluster, core) + L1_SIZE
+
+
+def l2_base(cluster):
+    return cluster_base(cluster) + L2_OFFSET
+
+
+def idma_base(cluster, index):
+    return cluster_base(cluster) + IDMA_OFFSET + index * IDMA_SIZE
+
+
+class SpmCluster(SubSystem):
+    """num_cores cores with private L1I/L1D SPMs, a shared L2 SPM and an
+    IDMA. idma_params are passed to every IDMA, e.g. burst_size. Call
+    connect_global() to attach the cluster to the second-level crossbar,
+    and map_process() after m5.instantiate()."""
+
+    def __init__(self, cluster_id, num_cores, cpu_class,
+                 spm_latency='2ns', spm_bandwidth='32GiB/s',
+                 bridge_delay='1ns', alias_decode=False, num_clusters=1,
+                 idma_per_core=False, idma_params=None, **kwargs):
+        super().__init__(**kwargs)
+
+        if not 1 <= num_cores <= MAX_CORES:
+            raise ValueError(f"a cluster holds 1..{MAX_CORES} cores, "
+                             f"got {num_cores}")
+
+        self._cluster_id = cluster_id
+        self._num_cores = num_cores
+        self._bridge_delay = bridge_delay
+        self._alias_decode = alias_decode
+        self._num_clusters = num_clusters
+        self._idma_per_core = idma_per_core
+        idma_params = idma_params or {}
+
+        # 簇内第一层级交叉开关，沿用 hybrid_memory.py 的零延迟设置
+        self.xbar1 = IOXBar(frontend_latency=0, forward_latency=0,
+                            response_latency=0)
+        self.xbar2 = IOXBar(frontend_latency=0, forward_latency=0,
+                            response_latency=0)
+
+        self.l2_spm = ScratchpadMemory(
+            range=AddrRange(start=l2_base(cluster_id), size=L2_SIZE),
+            latency=spm_latency, bandwidth=spm_bandwidth)
+        self.xbar1.mem_side_ports = self.l2_spm.port
+        self.xbar2.mem_side_ports = self.l2_spm.dma_port
+
+        if idma_per_core:
+            idmas = [IDMA(pio_addr=idma_base(cluster_id, k),
+                          pio_size=IDMA_SIZE, **idma_params)
+                     for k in range(num_cores)]
+        else:
+            idmas = [IDMA(pio_addr=idma_base(cluster_id, 0),
+                          pio_size=IDMA_SIZE, num_channels=num_cores,
+                          **idma_params)]
+        for idma in idmas:
+            self.xbar1.mem_side_ports = idma.pio
+            idma.dma = self.xbar2.cpu_side_ports
+        self.idmas = idmas
+
+        cpus = []
+        l1i_spms = []
+        l1d_spms = []
+        mappers = []
+        for k in range(num_cores):
+            cpu = cpu_class(cpu_id=cluster_id * MAX_CORES + k)
+            cpu.ArchISA.riscv_type = "RV32"
+            cpu.createInterruptController()
+            # IDMA 完成中断接到核心的本地中断 16，共享的 IDMA 广播给所有核心
+            cpu.ArchISA.wfi_resume_on_pending = True
+            cpu.interrupts[0].local_interrupt_ids = [0]
+            idma = idmas[k] if idma_per_core else idmas[0]
+            idma.int_pin = cpu.interrupts[0].local_interrupt_pins[0]
+
+            l1i = ScratchpadMemory(
+                range=AddrRange(start=l1i_base(cluster_id, k), size=L1_SIZE),
+                latency=spm_latency, bandwidth=spm_bandwidth)
+            l1d = ScratchpadMemory(
+                range=AddrRange(start=l1d_base(cluster_id, k), size=L1_SIZE),
+                latency=spm_latency, bandwidth=spm_bandwidth)
+
+            if alias_decode:
+                # 簇真名窗口只覆盖实际存在的簇
+                global_alias = AddrRange(start=GLOBAL_ALIAS,
+                                         size=num_clusters * L2_SIZE)
+                imapper = SpmAliasMapper(cluster_id=cluster_id, core_id=k,
+                                         num_clusters=num_clusters,
+                                         global_alias=global_alias)
+                dmapper = SpmAliasMapper(cluster_id=cluster_id, core_id=k,
+                                         num_clusters=num_clusters,
+                                         global_alias=global_alias)
+                cpu.icache_port = imapper.cpu_side_port
+                cpu.dcache_port = dmapper.cpu_side_port
+                imapper.mem_side_port = self.xbar1.cpu_side_ports
+                dmapper.mem_side_port = self.xbar1.cpu_side_ports
+                mappers += [imapper, dmapper]
+            else:
+                cpu.icache_port = self.xbar1.cpu_side_ports
+                cpu.dcache_port = self.xbar1.cpu_side_ports
+            self.xbar1.mem_side_ports = l1i.port
+            self.xbar1.mem_side_ports = l1d.port
+            self.xbar2.mem_side_ports = l1i.dma_port
+            self.xbar2.mem_side_ports = l1d.dma_port
+
+            cpus.append(cpu)
+            l1i_spms.append(l1i)
+            l1d_spms.append(l1d)
+
+        self.cpus = cpus
+        self.l1i_spms = l1i_spms
+        self.l1d_spms = l1d_spms
+        if mappers:
+            self.alias_mappers = mappers
+            # IDMA 的 DMA 端口前没有译码器，翻译后用发起核心的数据端译码器
+            # 把别名换成真名
+            for k, idma in enumerate(idmas):
+                owners = [k] if idma_per_core else range(num_cores)
+                idma.alias_cpus = [cpus[c] for c in owners]
+                idma.alias_mappers = [mappers[2 * c + 1] for c in owners]
+
+    def connect_global(self, global_xbar, remote_ranges, global_eventq=None):
+        """Attach the cluster to the second-level crossbar.
+
+        remote_ranges are the addresses outside this cluster (other
+        clusters, DDR) that the cores and the IDMA may reach. Other
+        clusters reach this one through its real-name window, i.e. the
+        L2 SPM and, for privileged/initialisation code, the L1 SPMs.
+
+        global_eventq is the event queue of the second level when the
+        cluster runs on an event queue of its own (eventq_index). The
+        links then cross host threads through ThreadBridges, which carry
+        the bridge delay; it must not be shorter than root.sim_quantum."""
+        if global_eventq is None:
+            delay = self._bridge_delay
+        else:
+            # Bridge 只负责地址过滤和缓冲，链路延迟由 ThreadBridge 承担
+            delay = "0ns"
+        self.uplink1 = Bridge(ranges=remote_ranges, delay=delay)
+        self.uplink2 = Bridge(ranges=remote_ranges, delay=delay)
+        self.downlink = Bridge(ranges=[cluster_range(self._cluster_id)],
+                               delay=delay)
+
+        self.xbar1.mem_side_ports = self.uplink1.cpu_side_port
+        self.xbar2.mem_side_ports = self.uplink2.cpu_side_port
+        self.downlink.mem_side_port = self.xbar2.cpu_side_ports
+
+        if global_eventq is None:
+            self.uplink1.mem_side_port = global_xbar.cpu_side_ports
+            self.uplink2.mem_side_port = global_xbar.cpu_side_ports
+            global_xbar.mem_side_ports = self.downlink.cpu_side_port
+            return
+
+        # 上行 ThreadBridge 的 out_port 一侧在第二层级的事件队列上，
+        # 下行的 in_port 一侧在第二层级的事件队列上，另一侧都是本簇
+        self.uplink1_thread = ThreadBridge(eventq_index=global_eventq,
+                                           delay=self._bridge_delay)
+        self.uplink2_thread = ThreadBridge(eventq_index=global_eventq,
+                                           delay=self._bridge_delay)
+        self.downlink_thread = ThreadBridge(in_eventq_index=global_eventq,
+                                            delay=self._bridge_delay)
+
+        self.uplink1.mem_side_port = self.uplink1_thread.in_port
+        self.uplink1_thread.out_port = global_xbar.cpu_side_ports
+        self.uplink2.mem_side_port = self.uplink2_thread.in_port
+        self.uplink2_thread.out_port = global_xbar.cpu_side_ports
+        global_xbar.mem_side_ports = self.downlink_thread.in_port
+        self.downlink_thread.out_port = self.downlink.cpu_side_port
+
+    def create_workloads(self, cmd, first_pid):
+        """Give every core its own process running cmd."""
+        for k, cpu in enumerate(self.cpus):
+            process = Process(pid=first_pid + k)
+            process.cmd = cmd
+            cpu.workload = process
+            cpu.createThreads()
+
+    def map_process(self):
+        """Map the program-visible SPM addresses of every core onto its own
+        SPMs. Pages the loader already placed there are copied over."""
+        for k, cpu in enumerate(self.cpus):
+            process = cpu.workload[0]
+            process.map(L1I_VADDR, l1i_base(self._cluster_id, k), L1_SIZE,
+                        clobber=True)
+            process.map(L1D_VADDR, l1d_base(self._cluster_id, k), L1_SIZE,
+                        clobber=True)
+            if self._alias_decode:
+                # 别名地址原样交给 SpmAliasMapper 译码
+                process.map(L2_VADDR, L2_VADDR, L2_SIZE)
+                process.map(CLUSTER_ALIAS, CLUSTER_ALIAS, CLUSTER_STRIDE)
+                process.map(GLOBAL_ALIAS, GLOBAL_ALIAS,
+                            self._num_clusters * L2_SIZE)
+            else:
+                process.map(L2_VADDR, l2_base(self._cluster_id), L2_SIZE,
+                            clobber=True)
+            idma = k if self._idma_per_core else 0
+            process.map(IDMA_VADDR, idma_base(self._cluster_id, idma),
+                        IDMA_SIZE, clobber=True)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# IDMA burst-size / outstanding-burst sweep
+#
+# 用普通 python3 运行（不是 gem5 配置脚本）。对每组 (burst_size,
+# max_inflight_bursts) 启动一次 gem5，在单核单簇的 manycore.py 上运行
+# spm_dma_bw，收集 L1I/L1D/L2 SPM 之间每个方向的拷贝带宽，输出 CSV：
+#
+#   python3 configs/spm/dma_sweep.py --gem5 build/ALL/gem5.opt \
+#       --out m5out/dma_sweep.csv
+#
+# 最后按拷贝方向打印带宽最高的设置。
+
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+
+BURST_SIZES = [64, 128, 256, 512, 1024, 2048, 4096]
+INFLIGHT = [1, 2, 4, 8, 16]
+
+# spm_dma_bw 输出的格式：bw <src>-><dst> <bytes> <cycles>
+BW_LINE = re.compile(r"^bw (\S+) (\d+) (\d+)$", re.M)
+
+here = os.path.dirname(os.path.abspath(__file__))
+gem5_root = os.path.dirname(os.path.dirname(here))
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--gem5",
+                    default=os.path.join(gem5_root, "build/ALL/gem5.opt"))
+parser.add_argument("--binary",
+                    default=os.path.join(
+                        gem5_root,
+                        "tests/test-progs/spm_dma_bw/bin/spm_dma_bw"))
+parser.add_argument("--bursts", type=int, nargs="+", default=BURST_SIZES,
+                    help="Burst sizes in bytes")
+parser.add_argument("--inflight", type=int, nargs="+", default=INFLIGHT,
+                    help="Maximum outstanding bursts")
+parser.add_argument("--clock", default="1GHz")
+parser.add_argument("--outdir", default="m5out/dma_sweep",
+                    help="Parent of the per-run gem5 output directories")
+parser.add_argument("--out", default="-", help="CSV file, - for stdout")
+args = parser.parse_args()
+
+rows = []
+for burst in args.bursts:
+    for inflight in args.inflight:
+        outdir = os.path.join(args.outdir, f"b{burst}_i{inflight}")
+        cmd = [args.gem5, f"--outdir={outdir}",
+               os.path.join(here, "manycore.py"),
+               "--clusters", "1", "--cores", "1", "--clock", args.clock,
+               "--idma-burst-size", str(burst),
+               "--idma-inflight", str(inflight),
+               "--binary", args.binary]
+        print(f"burst {burst:5d} B, {inflight:2d} outstanding ...",
+              file=sys.stderr)
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            sys.stderr.write(result.stderr)
+            sys.exit(f"gem5 failed for burst {burst}, inflight {inflight}")
+
+        found = BW_LINE.findall(result.stdout)
+        if not found:
+            sys.exit(f"no bandwidth lines in the output of {outdir}")
+        for pair, nbytes, cycles in found:
+            rows.append({"burst_size": burst, "max_inflight": inflight,
+                         "copy": pair, "bytes": int(nbytes),
+                         "cycles": int(cycles),
+                         "bytes_per_cycle": int(nbytes) / int(cycles)})
+
+fields = ["burst_size", "max_inflight", "copy", "bytes", "cycles",
+          "bytes_per_cycle"]
+out = sys.stdout if args.out == "-" else open(args.out, "w", newline="")
+writer = csv.DictWriter(out, fieldnames=fields)
+writer.writeheader()
+writer.writerows(rows)
+if out is not sys.stdout:
+    out.close()
+
+print("\nBest setting per copy direction:", file=sys.stderr)
+for pair in dict.fromkeys(r["copy"] for r in rows):
+    best = max((r for r in rows if r["copy"] == pair),
+               key=lambda r: r["bytes_per_cycle"])
+    print(f"  {pair:10s} {best['bytes_per_cycle']:6.2f} B/cycle at "
+          f"burst {best['burst_size']} B, {best['max_inflight']} outstanding",
+          file=sys.stderr)
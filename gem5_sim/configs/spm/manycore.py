@@ -0,0 +1,200 @@
+# Many-core SPM board (docs/mem_hier_v0.md 1.2)
+#
+# --clusters 个 SpmCluster 通过第二层级交叉开关互连，DDR 挂在第二层级上。
+# 每个核心运行同一个程序的独立进程，程序看到的 SPM 地址与
+# hybrid_memory.py 相同，因此 spm_test 等程序无需重新链接。
+#
+#   ./build/ALL/gem5.opt configs/spm/manycore.py --clusters 8 --cores 8
+#
+# 从 1 核到 64 核扫描时只需改变 --clusters 和 --cores。
+#
+# --noc mesh/ring 用 noc.py 中的路由器网络代替单个交叉开关，第 c 个簇挂在
+# 第 c 个路由器上，--ddr-channels 个 DDR 控制器按 DDR_INTLV 字节交织，
+# 均匀分布在各路由器上：
+#
+#   ./build/ALL/gem5.opt configs/spm/manycore.py --clusters 8 --cores 8 \
+#       --noc mesh --noc-width 16 --noc-hop-latency 2ns --ddr-channels 2
+#
+# --partitioned 把每个簇放到自己的事件队列（宿主线程）上，第二层级互连和 DDR
+# 在队列 0 上。簇与第二层级之间的链路换成 ThreadBridge，链路延迟
+# --cluster-link-latency 就是量子的上限，结果对给定的 --quantum 是确定的：
+#
+#   ./build/ALL/gem5.opt configs/spm/manycore.py --clusters 8 --cores 8 \
+#       --partitioned --cluster-link-latency 10ns
+
+import argparse
+import os
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import convert
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from cluster import MAX_CORES, SpmCluster, cluster_range
+from noc import SpmNoC
+
+DDR_BASE = 0x2_0000_0000
+DDR_INTLV = 256
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--clusters", type=int, default=1,
+                    help="Number of clusters (1-8)")
+parser.add_argument("--cores", type=int, default=MAX_CORES,
+                    help=f"Cores per cluster (1-{MAX_CORES})")
+parser.add_argument("--cpu-type", default="RiscvTimingSimpleCPU",
+                    help="CPU model of every core")
+parser.add_argument("--clock", default="1GHz")
+parser.add_argument("--ddr-size", default="512MiB")
+parser.add_argument("--ddr-channels", type=int, default=1,
+                    help="Number of interleaved DDR controllers")
+parser.add_argument("--noc", choices=["xbar", "mesh", "ring"], default="xbar",
+                    help="Second-level interconnect between the clusters")
+parser.add_argument("--noc-latency", type=int, default=1,
+                    help="Latency of the inter-cluster crossbar or of each "
+                         "NoC router in cycles")
+parser.add_argument("--noc-width", type=int, default=16,
+                    help="Link width of the NoC routers in bytes")
+parser.add_argument("--noc-hop-latency", default="1ns",
+                    help="Latency of each NoC link")
+parser.add_argument("--noc-link-depth", type=int, default=16,
+                    help="Packets buffered per NoC link before it applies "
+                         "back-pressure")
+parser.add_argument("--cluster-link-latency", default="1ns",
+                    help="Latency of the bridges between a cluster and the "
+                         "second-level interconnect")
+parser.add_argument("--partitioned", action="store_true",
+                    help="Simulate every cluster on its own event queue "
+                         "and host thread")
+parser.add_argument("--quantum", default=None,
+                    help="Synchronization quantum of --partitioned, at most "
+                         "and by default --cluster-link-latency")
+parser.add_argument("--alias-decode", action="store_true",
+                    help="Decode the cluster and global SPM aliases with "
+                         "SpmAliasMapper instead of the page tables")
+parser.add_argument("--idma-per-core", action="store_true",
+                    help="Give every core its own IDMA instead of one "
+                         "shared IDMA per cluster")
+parser.add_argument("--idma-burst-size", type=int, default=64,
+                    help="IDMA burst and DMA packet size in bytes (64-4096)")
+parser.add_argument("--idma-inflight", type=int, default=4,
+                    help="Maximum outstanding read bursts per IDMA transfer")
+parser.add_argument("--binary",
+                    default="tests/test-progs/spm_test/bin/spm_test")
+parser.add_argument("--options", default="",
+                    help="Arguments passed to the program")
+args = parser.parse_args()
+
+if not 1 <= args.clusters <= 8:
+    parser.error("--clusters must be between 1 and 8")
+if args.ddr_channels < 1 or args.ddr_channels & (args.ddr_channels - 1):
+    parser.error("--ddr-channels must be a power of two")
+link_latency = convert.anyToLatency(args.cluster_link_latency)
+quantum = convert.anyToLatency(args.quantum or args.cluster_link_latency)
+if args.partitioned and not 0 < quantum <= link_latency:
+    parser.error("--quantum must be positive and at most "
+                 "--cluster-link-latency")
+
+system = System()
+root = Root(full_system=False, system=system)
+if args.partitioned:
+    # 队列 0 是第二层级互连、DDR 和 system，第 c 个簇在队列 c + 1 上
+    m5.ticks.fixGlobalFrequency()
+    root.sim_quantum = m5.ticks.fromSeconds(quantum)
+
+system.clk_domain = SrcClockDomain(clock=args.clock,
+                                   voltage_domain=VoltageDomain())
+system.mem_mode = "timing"
+
+# 进程的代码、栈和堆先由加载器分配在 DDR 中，map_process() 再把 SPM 地址
+# 重新映射到各核心的 SPM
+ddr_range = AddrRange(start=DDR_BASE, size=args.ddr_size)
+system.mem_ranges = [ddr_range]
+intlv_bits = args.ddr_channels.bit_length() - 1
+ddr_ctrls = []
+for i in range(args.ddr_channels):
+    if intlv_bits:
+        ctrl_range = AddrRange(
+            start=DDR_BASE, size=args.ddr_size,
+            intlvHighBit=DDR_INTLV.bit_length() - 2 + intlv_bits,
+            intlvBits=intlv_bits, intlvMatch=i)
+    else:
+        ctrl_range = ddr_range
+    ddr_ctrls.append(SimpleMemory(range=ctrl_range, latency="50ns",
+                                  bandwidth="12.8GiB/s"))
+system.ddr = ddr_ctrls
+
+# staging FIFO 至少要容纳所有在途的 burst
+idma_params = dict(burst_size=args.idma_burst_size,
+                   max_inflight_bursts=args.idma_inflight,
+                   staging_fifo_depth=max(8, args.idma_inflight))
+
+cpu_class = getattr(m5.objects, args.cpu_type)
+clusters = [SpmCluster(c, args.cores, cpu_class,
+                       bridge_delay=args.cluster_link_latency,
+                       alias_decode=args.alias_decode,
+                       idma_per_core=args.idma_per_core,
+                       idma_params=idma_params,
+                       num_clusters=args.clusters,
+                       eventq_index=c + 1 if args.partitioned else 0)
+            for c in range(args.clusters)]
+system.clusters = clusters
+global_eventq = 0 if args.partitioned else None
+
+if args.noc == "xbar":
+    # 第二层级交叉开关，不支持一致性
+    system.noc = IOXBar(forward_latency=args.noc_latency)
+    for ctrl in ddr_ctrls:
+        system.noc.mem_side_ports = ctrl.port
+    system.system_port = system.noc.cpu_side_ports
+
+    for c, cluster in enumerate(clusters):
+        remote = [cluster_range(o) for o in range(args.clusters) if o != c]
+        cluster.connect_global(system.noc, remote + [ddr_range],
+                               global_eventq)
+else:
+    system.noc = SpmNoC(args.clusters, topology=args.noc,
+                        width=args.noc_width,
+                        router_latency=args.noc_latency,
+                        hop_latency=args.noc_hop_latency,
+                        link_depth=args.noc_link_depth)
+    for i, ctrl in enumerate(ddr_ctrls):
+        node = i * args.clusters // args.ddr_channels
+        system.noc.attach_target(node, ctrl.port, [ctrl.range])
+    system.noc.attach_requestor(0, system.system_port)
+
+    for c, cluster in enumerate(clusters):
+        remote = [cluster_range(o) for o in range(args.clusters) if o != c]
+        cluster.connect_global(system.noc.router(c), remote + [ddr_range],
+                               global_eventq)
+        system.noc.add_target_ranges(c, [cluster_range(c)])
+    system.noc.build()
+
+system.workload = SEWorkload.init_compatible(args.binary)
+cmd = [args.binary] + args.options.split()
+for c, cluster in enumerate(clusters):
+    cluster.create_workloads(cmd, first_pid=100 + c * MAX_CORES)
+
+m5.instantiate()
+
+for cluster in clusters:
+    cluster.map_process()
+
+print("=" * 70)
+print(f"{args.clusters} cluster(s) x {args.cores} core(s), "
+      f"{args.cpu_type} @ {args.clock}, {args.noc} interconnect, "
+      f"{args.ddr_channels} DDR channel(s)")
+if args.partitioned:
+    print(f"  partitioned: {args.clusters + 1} event queues, "
+          f"quantum {root.sim_quantum} ticks")
+for c in range(args.clusters):
+    print(f"  cluster {c}: {cluster_range(c)}")
+print("=" * 70)
+
+exit_event = m5.simulate()
+
+print()
+print("=" * 70)
+print(f"Simulation finished @ tick {m5.curTick()}")
+print(f"Exit reason: {exit_event.getCause()}")
+print("=" * 70)
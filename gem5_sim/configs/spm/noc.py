@@ -0,0 +1,126 @@
+# Inter-cluster NoC (docs/mem_hier_v0.md 1.2)
+#
+# 第二层级互连：每个节点是一个 NoncoherentXBar 路由器，相邻路由器之间用一对
+# 单向 Bridge 连接。
+#   - 路由器的 width 即链路宽度，每个包占用端口 header_latency + size/width 周期
+#   - Bridge 的 delay 是每跳的链路延迟，req_size/resp_size 是链路缓冲深度，
+#     缓冲满时 Bridge 拒绝请求，反压沿路径逐跳传回源端
+#   - Bridge 的 ranges 就是路由表：mesh 采用 XY 维序路由，ring 走最短方向
+# 每个目标地址在每个路由器上只有一个出口，因此不会形成地址环路。
+#
+# 用法：
+#   noc = SpmNoC(num_nodes, topology="mesh")
+#   noc.attach_target(node, port, ranges)   # DDR 控制器等目标
+#   noc.add_target_ranges(node, ranges)     # 已自行连到路由器的簇窗口
+#   noc.attach_requestor(node, port)        # 簇的上行端口、system_port
+#   noc.build()                             # 所有目标挂好之后生成链路
+
+from m5.objects import *
+
+
+class SpmNoC(SubSystem):
+    """A mesh or ring of NoncoherentXBar routers joined by Bridges."""
+
+    def __init__(self, num_nodes, topology="mesh", width=16,
+                 router_latency=1, hop_latency="1ns", link_depth=16,
+                 **kwargs):
+        super().__init__(**kwargs)
+
+        if num_nodes < 1:
+            raise ValueError("the NoC needs at least one node")
+        if topology not in ("mesh", "ring"):
+            raise ValueError(f"unknown NoC topology '{topology}'")
+
+        self._num_nodes = num_nodes
+        self._topology = topology
+        self._hop_latency = hop_latency
+        self._link_depth = link_depth
+        # 每个节点上挂的目标地址，build() 据此生成各链路的路由表
+        self._targets = [[] for _ in range(num_nodes)]
+
+        # mesh 尽量接近正方形，最后一行可以不满
+        self._cols = 1
+        while self._cols * self._cols < num_nodes:
+            self._cols += 1
+
+        self.routers = [
+            NoncoherentXBar(width=width, frontend_latency=router_latency,
+                            forward_latency=0, response_latency=router_latency)
+            for _ in range(num_nodes)]
+
+    def router(self, node):
+        return self.routers[node]
+
+    def coords(self, node):
+        return node % self._cols, node // self._cols
+
+    def attach_target(self, node, port, ranges):
+        """Connect a responder, e.g. a DDR controller, to a router. ranges
+        are the addresses it serves."""
+        self.routers[node].mem_side_ports = port
+        self.add_target_ranges(node, ranges)
+
+    def add_target_ranges(self, node, ranges):
+        """Route ranges to node for a responder connected to the router
+        by other means, e.g. SpmCluster.connect_global()."""
+        self._targets[node] += list(ranges)
+
+    def attach_requestor(self, node, port):
+        """Connect a requestor (a cluster uplink, the system port)."""
+        self.routers[node].cpu_side_ports = port
+
+    def neighbours(self, node):
+        if self._topology == "ring":
+            if self._num_nodes == 1:
+                return []
+            if self._num_nodes == 2:
+                return [1 - node]
+            return [(node + 1) % self._num_nodes,
+                    (node - 1) % self._num_nodes]
+
+        x, y = self.coords(node)
+        result = []
+        for nx, ny in ((x + 1, y), (x - 1, y), (x, y + 1), (x, y - 1)):
+            other = ny * self._cols + nx
+            if 0 <= nx < self._cols and ny >= 0 and other < self._num_nodes:
+                result.append(other)
+        return result
+
+    def next_hop(self, src, dst):
+        """Neighbour of src on the way to dst."""
+        if self._topology == "ring":
+            n = self._num_nodes
+            # 顺时针距离不超过一半时顺时针走，否则逆时针
+            if (dst - src) % n <= n // 2:
+                return (src + 1) % n
+            return (src - 1) % n
+
+        # XY 维序路由：先走 X 方向，再走 Y 方向。最后一行不满时目标所在列
+        # 可能没有当前行的路由器，这时先走 Y 方向
+        x, y = self.coords(src)
+        dx, dy = self.coords(dst)
+        if dx != x:
+            nx = x + (1 if dx > x else -1)
+            if y * self._cols + nx < self._num_nodes:
+                return y * self._cols + nx
+        return (y + (1 if dy > y else -1)) * self._cols + x
+
+    def build(self):
+        """Create the links once every target is attached."""
+        links = []
+        for src in range(self._num_nodes):
+            for nbr in self.neighbours(src):
+                ranges = []
+                for dst in range(self._num_nodes):
+                    if dst != src and self.next_hop(src, dst) == nbr:
+                        ranges += self._targets[dst]
+                if not ranges:
+                    continue
+
+                link = Bridge(ranges=ranges, delay=self._hop_latency,
+                              req_size=self._link_depth,
+                              resp_size=self._link_depth)
+                self.routers[src].mem_side_ports = link.cpu_side_port
+                link.mem_side_port = self.routers[nbr].cpu_side_ports
+                links.append(link)
+        self.links = links
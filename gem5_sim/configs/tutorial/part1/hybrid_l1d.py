@@ -0,0 +1,157 @@
+# Hybrid L1D Configuration
+# Same system as hybrid_memory.py, but the L1D is a HybridCache: one 64KiB
+# SRAM whose cache/SPM split is set by the L1D_CACHE_VOL_CFG register
+# (docs/mem_hier_v0.md 2.1). The cache part caches the L2 SPM.
+# The IDMA reaches the L2 SPM without going through the L1D, so software
+# writes L1D_CACHE_FLUSH (0x80070004) before the IDMA reads L2 data the CPU
+# wrote and after the IDMA wrote L2 data the CPU is going to read.
+#
+#   gem5.opt configs/tutorial/part1/hybrid_l1d.py --l1d-cache-cfg 2
+
+import argparse
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--l1d-cache-cfg", type=int, default=0,
+                    help="Initial L1D_CACHE_VOL_CFG: 0=0KB 1=4KB 2=8KB "
+                         "3=16KB 4=32KB cache, the rest of the 64KiB is SPM")
+parser.add_argument("--binary", default="tests/test-progs/spm_test/bin/spm_test")
+args = parser.parse_args()
+
+# Create system
+system = System()
+
+# Create Root immediately
+root = Root(full_system=False, system=system)
+
+# Clock and voltage
+voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock='1GHz', voltage_domain=voltage_domain)
+system.mem_mode = "timing"
+
+# CPU
+system.cpu = RiscvTimingSimpleCPU()
+system.cpu.ArchISA.riscv_type = "RV32"
+system.cpu.createInterruptController()
+# IDMA 完成中断接到本地中断 16 (local_interrupt_ids[0] = 0)，
+# wfi 在有挂起中断时不进入睡眠，避免错过已经完成的传输
+system.cpu.ArchISA.wfi_resume_on_pending = True
+system.cpu.interrupts[0].local_interrupt_ids = [0]
+
+system.mem_ranges = [
+    AddrRange(start=0x80000000, size='64kB'),  # 对应 L1i
+    AddrRange(start=0x80010000, size='64kB'),  # 对应 L1d
+    AddrRange(start=0x80020000, size='256kB'),  # 对应 L2
+    AddrRange(start=0x80060000, size='4kB'),  # 对应 IDMA
+    AddrRange(start=0x80070000, size='4kB'),  # L1D_CACHE_VOL_CFG/FLUSH
+
+]
+
+system.xbar1 = IOXBar(
+    frontend_latency=0,
+    forward_latency=0,
+    response_latency=0,
+)
+
+system.xbar2 = IOXBar(
+    frontend_latency=0,
+    forward_latency=0,
+    response_latency=0,
+)
+
+# ============================================================================
+# Memory Hierarchy
+# ============================================================================
+
+# L1I SPM (Instruction & Code) - 0x80000000
+system.l1i_spm = ScratchpadMemory(
+    clk_domain=system.clk_domain,
+    range=AddrRange(start=0x80000000, size='64KiB'),
+    latency='2ns',
+    bandwidth='32GiB/s'
+)
+
+# L1D (Data) - 0x80010000，低地址部分为 Cache，其余为 SPM
+system.l1d = HybridCache(
+    clk_domain=system.clk_domain,
+    spm_range=AddrRange(start=0x80010000, size='64KiB'),
+    cfg_addr=0x80070000,
+    flush_addr=0x80070004,
+    cache_vol_cfg=args.l1d_cache_cfg,
+)
+
+
+# L2 SPM (Data) - 0x80020000
+system.l2_spm = ScratchpadMemory(
+    clk_domain=system.clk_domain,
+    range=AddrRange(start=0x80020000, size='256KiB'),
+    latency='2ns',
+    bandwidth='32GiB/s'
+)
+
+system.idma=IDMA(
+    # clk_domain=system.clk_domain,
+    # pio_addr=AddrRange(start=0x80030000, size='4KiB'),
+    # latency='1ns',
+    # bandwidth='16GiB/s'
+)
+
+# ============================================================================
+# Connections
+# ============================================================================
+
+# 1. Connect CPU to Bus
+system.cpu.icache_port = system.xbar1.cpu_side_ports
+system.cpu.dcache_port = system.l1d.cpu_side
+system.l1d.mem_side = system.xbar1.cpu_side_ports
+
+system.xbar1.mem_side_ports = system.l1i_spm.port
+system.xbar1.mem_side_ports = system.l2_spm.port
+system.xbar1.mem_side_ports = system.idma.pio   # CPU 访问 IDMA 寄存器 (0x80060000) 必须接 pio
+
+system.idma.dma = system.xbar2.cpu_side_ports
+system.idma.int_pin = system.cpu.interrupts[0].local_interrupt_pins[0]
+
+system.xbar2.mem_side_ports = system.l1i_spm.dma_port
+system.xbar2.mem_side_ports = system.l1d.dma_port
+system.xbar2.mem_side_ports = system.l2_spm.dma_port
+
+
+binary = args.binary
+system.workload = SEWorkload.init_compatible(binary)
+
+process = Process()
+process.cmd = [binary]
+
+system.cpu.workload = process
+system.cpu.createThreads()
+
+# ============================================================================
+# Simulation
+# ============================================================================
+m5.instantiate()
+
+# 恒等映射 (VA = PA): 虚拟地址 = 物理地址，无操作系统页表转换
+process.map(0x80000000, 0x80000000, 0x10000)   # L1I SPM (Code)
+process.map(0x80010000, 0x80010000, 0x10000)   # L1D SPM
+process.map(0x80020000, 0x80020000, 0x40000, cacheable=True, clobber=True)  # L2 SPM
+process.map(0x80060000, 0x80060000, 0x1000, cacheable=False)  # IDMA 寄存器
+process.map(0x80070000, 0x80070000, 0x1000)    # L1D_CACHE_VOL_CFG/FLUSH
+print("=" * 70)
+print("Hybrid L1D Configuration (Bus-based)")
+print("=" * 70)
+print(f"L1I SPM: {system.l1i_spm.range}")
+print(f"L1D:     {system.l1d.spm_range}, "
+      f"L1D_CACHE_VOL_CFG = {args.l1d_cache_cfg}")
+print(f"L2 SPM:  {system.l2_spm.range}")
+print("=" * 70)
+
+exit_event = m5.simulate()
+
+print()
+print("=" * 70)
+print(f'Simulation finished @ tick {m5.curTick()}')
+print(f'Exit reason: {exit_event.getCause()}')
+print("=" * 70)
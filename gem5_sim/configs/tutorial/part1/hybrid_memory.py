@@ -4,9 +4,15 @@
 # - L2 SPM
 # - SystemXBar (Crossbar) interconnect
 
+import argparse
+
 import m5
 from m5.objects import *
 
+parser = argparse.ArgumentParser()
+parser.add_argument("--binary", default="tests/test-progs/spm_test/bin/spm_test")
+args = parser.parse_args()
+
 # Create system
 system = System()
 
@@ -22,6 +28,10 @@ system.mem_mode = "timing"
 system.cpu = RiscvTimingSimpleCPU()
 system.cpu.ArchISA.riscv_type = "RV32"
 system.cpu.createInterruptController()
+# IDMA 完成中断接到本地中断 16 (local_interrupt_ids[0] = 0)，
+# wfi 在有挂起中断时不进入睡眠，避免错过已经完成的传输
+system.cpu.ArchISA.wfi_resume_on_pending = True
+system.cpu.interrupts[0].local_interrupt_ids = [0]
 
 system.mem_ranges = [
     AddrRange(start=0x80000000, size='64kB'),  # 对应 L1i
@@ -93,13 +103,14 @@ system.xbar1.mem_side_ports = system.l2_spm.port
 system.xbar1.mem_side_ports = system.idma.pio   # CPU 访问 IDMA 寄存器 (0x80060000) 必须接 pio
 
 system.idma.dma = system.xbar2.cpu_side_ports
+system.idma.int_pin = system.cpu.interrupts[0].local_interrupt_pins[0]
 
 system.xbar2.mem_side_ports = system.l1i_spm.dma_port
 system.xbar2.mem_side_ports = system.l1d_spm.dma_port
 system.xbar2.mem_side_ports = system.l2_spm.dma_port
 
 
-binary = "tests/test-progs/spm_test/bin/spm_test"
+binary = args.binary
 system.workload = SEWorkload.init_compatible(binary)
 
 process = Process()
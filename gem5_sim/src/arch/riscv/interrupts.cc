@@ -253,6 +253,14 @@ Interrupts::raiseInterruptPin(uint32_t num)
     tc->getCpuPtr()->postInterrupt(tc->threadId(), num + 16, 0);
 }
 
+void
+Interrupts::lowerInterruptPin(uint32_t num)
+{
+    // Level-triggered sources such as device completion lines clear the
+    // pending bit once they are acknowledged.
+    tc->getCpuPtr()->clearInterrupt(tc->threadId(), num + 16, 0);
+}
+
 void
 Interrupts::serialize(CheckpointOut &cp) const
 {
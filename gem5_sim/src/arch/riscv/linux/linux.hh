@@ -479,6 +479,74 @@ class RiscvLinux32 : public RiscvLinux, public OpenFlagTable<RiscvLinux32>
         uint32_t mem_unit;
     };
 
+    // For writev/readv
+    struct tgt_iovec
+    {
+        uint32_t iov_base; // void *
+        uint32_t iov_len;
+    };
+
+    // Layout from the Linux uapi <linux/stat.h>, same on every ABI.
+    struct tgt_statx
+    {
+        /* 0x00 */
+        uint32_t stx_mask;
+        uint32_t stx_blksize;
+        uint64_t stx_attributes;
+        /* 0x10 */
+        uint32_t stx_nlink;
+        uint32_t stx_uid;
+        uint32_t stx_gid;
+        uint16_t stx_mode;
+        uint16_t stx_spare0;
+        /* 0x20 */
+        uint64_t stx_ino;
+        uint64_t stx_size;
+        uint64_t stx_blocks;
+        uint64_t stx_attributes_mask;
+        /* 0x40 */
+        int64_t  stx_atimeX;
+        uint32_t stx_atime_nsec;
+        int32_t  stx_atime_reserved;
+        int64_t  stx_btimeX;
+        uint32_t stx_btime_nsec;
+        int32_t  stx_btime_reserved;
+        int64_t  stx_ctimeX;
+        uint32_t stx_ctime_nsec;
+        int32_t  stx_ctime_reserved;
+        int64_t  stx_mtimeX;
+        uint32_t stx_mtime_nsec;
+        int32_t  stx_mtime_reserved;
+        /* 0x80 */
+        uint32_t stx_rdev_major;
+        uint32_t stx_rdev_minor;
+        uint32_t stx_dev_major;
+        uint32_t stx_dev_minor;
+        /* 0x90 */
+        uint64_t stx_mnt_id;
+        uint64_t stx_spare2;
+        /* 0xa0 */
+        uint64_t stx_spare3[12];
+        /* 0x100 */
+    };
+
+    // The kernel declares every field __aligned_u64, so the layout matches
+    // RV64 and pointers are zero extended.
+    struct tgt_clone_args
+    {
+        uint64_t flags;
+        uint64_t pidfd;
+        uint64_t child_tid;
+        uint64_t parent_tid;
+        uint64_t exit_signal;
+        uint64_t stack;
+        uint64_t stack_size;
+        uint64_t tls;
+        uint64_t set_tid;
+        uint64_t set_tid_size;
+        uint64_t cgroup;
+    };
+
     static void
     archClone(uint64_t flags,
               Process *pp, Process *cp,
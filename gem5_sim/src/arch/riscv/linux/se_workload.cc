@@ -652,7 +652,7 @@ SyscallDescTable<SEWorkload::SyscallABI64> EmuLinux::syscallDescs64 = {
     { 119,  "sched_setscheduler" },
     { 120,  "sched_getscheduler" },
     { 121,  "sched_getparam", sched_getparamFunc },
-    { 122,  "sched_setaffinity" },
+    { 122,  "sched_setaffinity", schedSetaffinityFunc<RiscvLinux64> },
     { 123,  "sched_getaffinity", schedGetaffinityFunc<RiscvLinux64> },
     { 124,  "sched_yield", ignoreWarnOnceFunc },
     { 125,  "sched_get_priority_max" },
@@ -1019,7 +1019,7 @@ SyscallDescTable<SEWorkload::SyscallABI32> EmuLinux::syscallDescs32 = {
     { 119,  "sched_setscheduler" },
     { 120,  "sched_getscheduler" },
     { 121,  "sched_getparam", sched_getparamFunc },
-    { 122,  "sched_setaffinity" },
+    { 122,  "sched_setaffinity", schedSetaffinityFunc<RiscvLinux32> },
     { 123,  "sched_getaffinity", schedGetaffinityFunc<RiscvLinux32> },
     { 124,  "sched_yield", ignoreWarnOnceFunc },
     { 125,  "sched_get_priority_max" },
@@ -1170,6 +1170,58 @@ SyscallDescTable<SEWorkload::SyscallABI32> EmuLinux::syscallDescs32 = {
     { 285,  "copy_file_range" },
     { 286,  "preadv2" },
     { 287,  "pwritev2" },
+    { 288,  "pkey_mprotect" },
+    { 289,  "pkey_alloc" },
+    { 290,  "pkey_free" },
+    { 291,  "statx", statxFunc<RiscvLinux32> },
+    { 292,  "io_pgetevents" },
+    { 293,  "rseq", ignoreWithEnosysFunc },
+    { 403,  "clock_gettime64", clock_gettimeFunc<RiscvLinux32> },
+    { 404,  "clock_settime64" },
+    { 405,  "clock_adjtime64" },
+    { 406,  "clock_getres_time64", clock_getresFunc<RiscvLinux32> },
+    { 407,  "clock_nanosleep_time64" },
+    { 408,  "timer_gettime64" },
+    { 409,  "timer_settime64" },
+    { 410,  "timerfd_gettime64" },
+    { 411,  "timerfd_settime64" },
+    { 412,  "utimensat_time64" },
+    { 413,  "pselect6_time64" },
+    { 414,  "ppoll_time64" },
+    { 416,  "io_pgetevents_time64" },
+    { 417,  "recvmmsg_time64" },
+    { 418,  "mq_timedsend_time64" },
+    { 419,  "mq_timedreceive_time64" },
+    { 420,  "semtimedop_time64" },
+    { 421,  "rt_sigtimedwait_time64", ignoreWarnOnceFunc },
+    { 422,  "futex_time64", futexFunc<RiscvLinux32> },
+    { 423,  "sched_rr_get_interval_time64" },
+    { 424,  "pidfd_send_signal" },
+    { 425,  "io_uring_setup" },
+    { 426,  "io_uring_enter" },
+    { 427,  "io_uring_register" },
+    { 428,  "open_tree" },
+    { 429,  "move_mount" },
+    { 430,  "fsopen" },
+    { 431,  "fsconfig" },
+    { 432,  "fsmount" },
+    { 433,  "fspick" },
+    { 434,  "pidfd_open" },
+    { 435,  "clone3", clone3Func<RiscvLinux32> },
+    { 436,  "close_range" },
+    { 437,  "openat2" },
+    { 438,  "pidfd_getfd" },
+    { 439,  "faccessat2" },
+    { 440,  "process_madvise" },
+    { 441,  "epoll_pwait2" },
+    { 442,  "mount_setattr" },
+    { 443,  "quotactl_fd" },
+    { 444,  "landlock_create_ruleset" },
+    { 445,  "landlock_add_rule" },
+    { 446,  "landlock_restrict_self" },
+    { 447,  "memfd_secret" },
+    { 448,  "process_mrelease" },
+    { 449,  "futex_waitv" },
     { 1024, "open", openFunc<RiscvLinux32> },
     { 1025, "link", linkFunc },
     { 1026, "unlink", unlinkFunc },
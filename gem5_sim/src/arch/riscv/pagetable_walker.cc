@@ -851,7 +851,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
     }
     else {
         //If we didn't return, we're setting up another read.
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             nextRead, oldRead->getSize(), flags, walker->requestorId);
 
         delete oldRead;
@@ -1019,7 +1019,7 @@ Walker::WalkerState::stepWalkGStage(PacketPtr &write)
     }
     else {
         //If we didn't return, we're setting up another read.
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             nextRead, oldRead->getSize(), flags, walker->requestorId);
 
         delete oldRead;
@@ -1182,7 +1182,7 @@ PacketPtr
 Walker::WalkerState::createReqPacket(Addr paddr, MemCmd cmd, size_t bytes)
 {
     Request::Flags flags = Request::PHYSICAL;
-    RequestPtr request = std::make_shared<Request>(
+    RequestPtr request = makeRequest(
         paddr, bytes, flags, walker->requestorId);
     PacketPtr pkt = new Packet(request, cmd);
     pkt->allocate();
@@ -595,13 +595,18 @@ TLB::translate(const RequestPtr &req, ThreadContext *tc,
          * need to ignore the upper bits beyond 32 bits.
          */
         Addr vaddr = getValidAddr(req->getVaddr(), tc, mode);
-        Addr paddr;
 
-        if (!p->pTable->translate(vaddr, paddr))
+        const EmulationPageTable::Entry *pte = p->pTable->lookup(vaddr);
+        if (!pte)
             return std::make_shared<GenericPageTableFault>(req->getVaddr());
 
+        Addr paddr = pte->paddr | p->pTable->pageOffset(vaddr);
         req->setPaddr(paddr);
 
+        // Pages mapped with cacheable=False, e.g. device registers
+        if (pte->flags & EmulationPageTable::Uncacheable)
+            req->setFlags(Request::UNCACHEABLE);
+
         return NoFault;
     }
 }
@@ -0,0 +1,101 @@
+#ifndef __BASE_SPSC_RING_HH__
+#define __BASE_SPSC_RING_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+/**
+ * Bounded lock-free ring buffer with a single producer thread and a
+ * single consumer thread.
+ *
+ * The producer only writes tail and the consumer only writes head, so
+ * neither needs a lock or a read-modify-write: a release store of its
+ * own index publishes the slot, and an acquire load of the other index
+ * makes the other side's slot writes visible. Each side keeps its own
+ * copy of the other side's index and only reloads it when the ring looks
+ * full or empty, so the two cache lines move between the cores only
+ * when they have to.
+ */
+template <typename T>
+class SpscRing
+{
+  public:
+    /** Room for at least capacity items, rounded up to a power of two. */
+    explicit SpscRing(size_t capacity)
+        : slots(size_t(1) << ceilLog2(capacity ? capacity : 1)),
+          mask(slots.size() - 1)
+    {}
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    size_t capacity() const { return slots.size(); }
+
+    /**
+     * Producer: append an item.
+     *
+     * @return False, without appending it, if the ring is full.
+     */
+    bool
+    push(const T &item)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == slots.size()) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == slots.size())
+                return false;
+        }
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: the oldest item, which stays in the ring until pop().
+     *
+     * @return nullptr if the ring is empty.
+     */
+    const T *
+    front()
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache)
+                return nullptr;
+        }
+        return &slots[h & mask];
+    }
+
+    /** Consumer: drop the item returned by front(). */
+    void
+    pop()
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+  private:
+    static constexpr size_t CacheLine = 64;
+
+    std::vector<T> slots;
+    const size_t mask;
+
+    /** Written by the consumer, with its copy of tail. */
+    alignas(CacheLine) std::atomic<size_t> head{0};
+    size_t tailCache = 0;
+
+    /** Written by the producer, with its copy of head. */
+    alignas(CacheLine) std::atomic<size_t> tail{0};
+    size_t headCache = 0;
+};
+
+} // namespace gem5
+
+#endif // __BASE_SPSC_RING_HH__
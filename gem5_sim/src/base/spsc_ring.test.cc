@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#include "base/spsc_ring.hh"
+
+using namespace gem5;
+
+TEST(SpscRingTest, RoundsUpCapacity)
+{
+    EXPECT_EQ(SpscRing<int>(0).capacity(), 1);
+    EXPECT_EQ(SpscRing<int>(5).capacity(), 8);
+    EXPECT_EQ(SpscRing<int>(16).capacity(), 16);
+}
+
+TEST(SpscRingTest, FifoUntilFull)
+{
+    SpscRing<int> ring(4);
+    EXPECT_EQ(ring.front(), nullptr);
+
+    for (int i = 0; i < 4; i++)
+        EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(4));
+
+    // Wrap around a few times
+    for (int i = 0; i < 20; i++) {
+        ASSERT_NE(ring.front(), nullptr);
+        EXPECT_EQ(*ring.front(), i);
+        ring.pop();
+        EXPECT_TRUE(ring.push(i + 4));
+    }
+    for (int i = 20; i < 24; i++) {
+        EXPECT_EQ(*ring.front(), i);
+        ring.pop();
+    }
+    EXPECT_EQ(ring.front(), nullptr);
+}
+
+TEST(SpscRingTest, TwoThreads)
+{
+    const uint64_t count = 1000000;
+    SpscRing<uint64_t> ring(64);
+
+    std::thread producer([&ring, count]() {
+        for (uint64_t i = 0; i < count; i++) {
+            while (!ring.push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    // Every item arrives once and in order. Keep draining after a
+    // mismatch so the producer finishes and can be joined.
+    uint64_t expected = 0;
+    uint64_t mismatches = 0;
+    while (expected < count) {
+        const uint64_t *item = ring.front();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (*item != expected)
+            mismatches++;
+        ring.pop();
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(ring.front(), nullptr);
+}
@@ -1447,8 +1447,7 @@ CPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
     commit.resetHtmStartsStops(tid);
 
     // notify l1 d-cache (ruby) that core has aborted transaction
-    RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+    RequestPtr req = makeRequest(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(thread[tid]->contextId());
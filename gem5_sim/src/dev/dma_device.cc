@@ -61,7 +61,8 @@ DmaPort::DmaPort(ClockedObject *dev, System *s,
     : RequestPort(dev->name() + ".dma"),
       device(dev), sys(s), requestorId(s->getRequestorId(dev)),
       sendEvent([this]{ sendDma(); }, dev->name()),
-      defaultSid(sid), defaultSSid(ssid), cacheLineSize(s->cacheLineSize())
+      defaultSid(sid), defaultSSid(ssid), cacheLineSize(s->cacheLineSize()),
+      chunkSize(cacheLineSize)
 { }
 
 void
@@ -128,8 +129,7 @@ DmaPort::handleResp(DmaReqState *state, Addr addr, Addr size, Tick delay)
 PacketPtr
 DmaPort::DmaReqState::createPacket()
 {
-    RequestPtr req = std::make_shared<Request>(
-            gen.addr(), gen.size(), flags, id);
+    RequestPtr req = makeRequest(gen.addr(), gen.size(), flags, id);
     if (sid.has_value()) {
         req->setStreamId(sid.value());
     }
@@ -199,14 +199,14 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    std::optional<uint32_t> ssid, Tick delay,
                    Request::Flags flag)
 {
-    DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d, cacheLineSize: %d\n", addr, size,
-            event ? event->scheduled() : -1, cacheLineSize);
+    DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d, chunkSize: %d\n", addr, size,
+            event ? event->scheduled() : -1, chunkSize);
 
     // One DMA request sender state for every action, that is then
-    // split into many requests and packets based on the block size,
-    // i.e. cache line size.
+    // split into many requests and packets based on the chunk size,
+    // i.e. the cache line size unless the device changed it.
     transmitList.push_back(
-            new DmaReqState(cmd, addr, cacheLineSize, size,
+            new DmaReqState(cmd, addr, chunkSize, size,
                 data, flag, requestorId, sid, ssid, event, delay));
 
     // In zero time, also initiate the sending of the packets for the request
@@ -48,6 +48,7 @@
 #include "base/addr_range_map.hh"
 #include "base/chunk_generator.hh"
 #include "base/circlebuf.hh"
+#include "base/intmath.hh"
 #include "dev/io_device.hh"
 #include "mem/backdoor.hh"
 #include "params/DmaVirtDevice.hh"
@@ -191,6 +192,10 @@ class DmaPort : public RequestPort, public Drainable
 
     const Addr cacheLineSize;
 
+    /** Largest packet a DMA action is split into, the cache line size
+     * unless the device sets its own burst length. */
+    Addr chunkSize;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt) override;
@@ -210,6 +215,15 @@ class DmaPort : public RequestPort, public Drainable
               uint8_t *data, std::optional<uint32_t> sid,
               std::optional<uint32_t> ssid, Tick delay, Request::Flags flag=0);
 
+    /** Split subsequent DMA actions into packets of up to size bytes. */
+    void
+    setChunkSize(Addr size)
+    {
+        fatal_if(!isPowerOf2(size),
+                 "DMA chunk size %d is not a power of two\n", size);
+        chunkSize = size;
+    }
+
     // Abort and remove any pending DMA transmissions.
     void abortPending();
 
@@ -24,6 +24,7 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5.params import *
+from m5.proxy import *
 from m5.SimObject import SimObject
 
 
@@ -34,19 +35,28 @@ class ThreadBridge(SimObject):
     access from one side to the other side could easily cause event scheduled
     on the wrong event queue.
 
-    ThreadBridge is used to migrate the EventQueue to the one used by
-    ThreadBridge itself before sending transation to the other side to avoid
-    the issue. The receiver side is expected to use the same EventQueue that
-    the ThreadBridge is using.
+    For atomic and functional accesses, ThreadBridge migrates to the
+    EventQueue used by ThreadBridge itself before sending the transaction
+    to the other side. The receiver side is expected to use the same
+    EventQueue that the ThreadBridge is using.
 
-    Given that this is only used for simulation speed accelerating, only the
-    atomic and functional access are supported.
+    Timing accesses are passed between the threads as messages in
+    lock-free single-producer single-consumer rings, so neither thread
+    takes a lock or goes through the async event queue insertion. A
+    message sent at tick t arrives at t + delay (plus the header and
+    payload delay of the packet) and is picked up by the receiving thread
+    at a quantum barrier, so delay must be at least root.sim_quantum. The
+    result only depends on the quantum, not on how the host threads are
+    scheduled.
+    Requests are flow controlled with req_size credits, which return to
+    the in_port side with the same delay once a request has left through
+    out_port, and resp_size slots are reserved for the responses.
 
     Example:
 
     sys.initator = Initiator(eventq_index=0)
     sys.target = Target(eventq_index=1)
-    sys.bridge = ThreadBridge(eventq_index=1)
+    sys.bridge = ThreadBridge(eventq_index=1, in_eventq_index=0)
 
     sys.initator.out_port = sys.bridge.in_port
     sys.bridge.out_port = sys.target.in_port
@@ -58,3 +68,12 @@ class ThreadBridge(SimObject):
 
     in_port = ResponsePort("Incoming port")
     out_port = RequestPort("Outgoing port")
+
+    in_eventq_index = Param.UInt32(
+        Parent.eventq_index, "Event queue of the objects behind in_port"
+    )
+    delay = Param.Latency(
+        "0ns", "Latency of timing accesses, at least the simulation quantum"
+    )
+    req_size = Param.Unsigned(16, "The number of requests in flight")
+    resp_size = Param.Unsigned(16, "The number of responses to reserve")
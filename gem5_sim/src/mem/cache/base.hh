@@ -117,6 +117,8 @@ class BaseCache : public ClockedObject
         Blocked_NoMSHRs = MSHRQueue_MSHRs,
         Blocked_NoWBBuffers = MSHRQueue_WriteBuffer,
         Blocked_NoTargets,
+        /** A subclass waits for the queues to drain, e.g. to resize */
+        Blocked_Reconfig,
         NUM_BLOCKED_CAUSES
     };
 
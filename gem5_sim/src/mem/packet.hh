@@ -61,6 +61,7 @@
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
+#include "mem/packet_pool.hh"
 #include "mem/request.hh"
 #include "sim/byteswap.hh"
 
@@ -353,6 +354,10 @@ class Packet : public Printable, public Extensible<Packet>
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data was allocated by allocate() from the
+        /// memory pool and is returned there when the packet is
+        /// destroyed
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -1054,6 +1059,19 @@ class Packet : public Printable, public Extensible<Packet>
         deleteData();
     }
 
+    /** Packets are allocated from the memory pool, see packet_pool.hh. */
+    static void *
+    operator new(std::size_t size)
+    {
+        return packet_pool::allocate(size, packet_pool::PacketObj);
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        packet_pool::deallocate(p);
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1355,10 +1373,12 @@ class Packet : public Printable, public Extensible<Packet>
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(POOLED_DATA))
+            packet_pool::deallocate(data);
+        else if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -1370,8 +1390,9 @@ class Packet : public Printable, public Extensible<Packet>
         // payload, actually allocate space
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
-            flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            flags.set(DYNAMIC_DATA|POOLED_DATA);
+            data = static_cast<PacketDataPtr>(
+                packet_pool::allocate(getSize(), packet_pool::PacketData));
         }
     }
 
@@ -0,0 +1,269 @@
+#include "mem/packet_pool.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+namespace packet_pool
+{
+
+namespace
+{
+
+// The block header holds the size class and the owning thread's cache,
+// and keeps the alignment of ::operator new
+constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+constexpr std::size_t ClassSizes[] = { 64, 128, 256, 512 };
+constexpr unsigned NumClasses = sizeof(ClassSizes) / sizeof(ClassSizes[0]);
+// Class of blocks from the host allocator, freed with ::operator delete
+constexpr unsigned HostBlock = NumClasses;
+constexpr std::size_t SlabSize = 64 * 1024;
+
+enum Counter
+{
+    HostAllocs = NumKinds,
+    SlabBytes,
+    RemoteFrees,
+    NumCounters
+};
+
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+struct ThreadCache;
+
+struct BlockHeader
+{
+    unsigned cls;
+    ThreadCache *owner;
+};
+static_assert(sizeof(BlockHeader) <= HeaderSize,
+              "the block header must fit in the alignment padding");
+
+struct ThreadCache
+{
+    FreeBlock *freeList[NumClasses] = {};
+
+    // Blocks of this thread freed by other threads. They push with a CAS
+    // and the owner takes the whole list at once, so there is no ABA.
+    std::atomic<FreeBlock *> remoteFree[NumClasses] = {};
+
+    // Written by the owning thread only and read when the statistics are
+    // dumped, when the threads are synchronized. The first NumKinds
+    // entries count the allocations of each kind.
+    uint64_t counts[NumCounters] = {};
+};
+
+std::atomic<bool> poolEnabled(false);
+
+std::mutex cachesLock;
+std::vector<ThreadCache *> caches;
+
+// The slabs of a thread are not reclaimed when it exits; simulation
+// threads live as long as the process.
+ThreadCache &
+threadCache()
+{
+    thread_local ThreadCache *cache = nullptr;
+    if (!cache) {
+        cache = new ThreadCache;
+        std::lock_guard<std::mutex> lock(cachesLock);
+        caches.push_back(cache);
+    }
+    return *cache;
+}
+
+unsigned
+sizeClass(std::size_t size)
+{
+    for (unsigned cls = 0; cls < NumClasses; cls++) {
+        if (size <= ClassSizes[cls])
+            return cls;
+    }
+    return HostBlock;
+}
+
+void
+refill(ThreadCache &tc, unsigned cls)
+{
+    // Take back the blocks other threads freed before carving a new slab,
+    // so a producer/consumer split across threads does not grow forever
+    FreeBlock *returned =
+        tc.remoteFree[cls].exchange(nullptr, std::memory_order_acquire);
+    if (returned) {
+        tc.freeList[cls] = returned;
+        return;
+    }
+
+    const std::size_t block = HeaderSize + ClassSizes[cls];
+    char *slab = static_cast<char *>(::operator new(SlabSize));
+    tc.counts[HostAllocs]++;
+    tc.counts[SlabBytes] += SlabSize;
+
+    for (std::size_t offset = 0; offset + block <= SlabSize;
+            offset += block) {
+        auto *free = reinterpret_cast<FreeBlock *>(slab + offset);
+        free->next = tc.freeList[cls];
+        tc.freeList[cls] = free;
+    }
+}
+
+uint64_t
+sumCaches(unsigned counter)
+{
+    std::lock_guard<std::mutex> lock(cachesLock);
+    uint64_t sum = 0;
+    for (const ThreadCache *tc : caches)
+        sum += tc->counts[counter];
+    return sum;
+}
+
+// Counts at the last resetStats()
+uint64_t resetCounts[NumCounters] = {};
+
+uint64_t
+sinceReset(unsigned counter)
+{
+    return sumCaches(counter) - resetCounts[counter];
+}
+
+struct PacketPoolStats : public statistics::Group
+{
+    PacketPoolStats();
+
+    void resetStats() override;
+
+    statistics::Value packets;
+    statistics::Value requests;
+    statistics::Value payloads;
+    statistics::Value hostAllocs;
+    statistics::Value slabBytes;
+    statistics::Value remoteFrees;
+    statistics::Formula hostAllocsPerObject;
+};
+
+PacketPoolStats poolStats;
+
+} // anonymous namespace
+
+void
+setEnabled(bool enabled)
+{
+    poolEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool
+enabled()
+{
+    return poolEnabled.load(std::memory_order_relaxed);
+}
+
+void *
+allocate(std::size_t size, Kind kind)
+{
+    ThreadCache &tc = threadCache();
+    tc.counts[kind]++;
+
+    unsigned cls = enabled() ? sizeClass(size) : HostBlock;
+    char *block;
+    if (cls == HostBlock) {
+        block = static_cast<char *>(::operator new(HeaderSize + size));
+        tc.counts[HostAllocs]++;
+    } else {
+        if (!tc.freeList[cls])
+            refill(tc, cls);
+        FreeBlock *free = tc.freeList[cls];
+        tc.freeList[cls] = free->next;
+        block = reinterpret_cast<char *>(free);
+    }
+
+    *reinterpret_cast<BlockHeader *>(block) = { cls, &tc };
+    return block + HeaderSize;
+}
+
+void
+deallocate(void *p)
+{
+    if (!p)
+        return;
+
+    char *block = static_cast<char *>(p) - HeaderSize;
+    const BlockHeader header = *reinterpret_cast<BlockHeader *>(block);
+    if (header.cls == HostBlock) {
+        ::operator delete(block);
+        return;
+    }
+
+    ThreadCache &tc = threadCache();
+    auto *free = reinterpret_cast<FreeBlock *>(block);
+    if (header.owner == &tc) {
+        free->next = tc.freeList[header.cls];
+        tc.freeList[header.cls] = free;
+        return;
+    }
+
+    // Hand the block back to the thread that carved it
+    tc.counts[RemoteFrees]++;
+    std::atomic<FreeBlock *> &list = header.owner->remoteFree[header.cls];
+    free->next = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(free->next, free,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+}
+
+PacketPoolStats::PacketPoolStats()
+    : statistics::Group(nullptr),
+    ADD_STAT(packets, statistics::units::Count::get(),
+             "Packets allocated"),
+    ADD_STAT(requests, statistics::units::Count::get(),
+             "Requests allocated through the pool"),
+    ADD_STAT(payloads, statistics::units::Count::get(),
+             "Packet data buffers allocated"),
+    ADD_STAT(hostAllocs, statistics::units::Count::get(),
+             "Allocations from the host allocator: slab refills and "
+             "oversized blocks, or every object when the pool is off"),
+    ADD_STAT(slabBytes, statistics::units::Byte::get(),
+             "Bytes of slabs taken from the host allocator"),
+    ADD_STAT(remoteFrees, statistics::units::Count::get(),
+             "Pooled blocks freed by another thread and returned to the "
+             "thread that allocated them"),
+    ADD_STAT(hostAllocsPerObject, statistics::units::Ratio::get(),
+             "Host allocations per pooled object")
+{
+    packets.functor([]() { return sinceReset(PacketObj); });
+    requests.functor([]() { return sinceReset(RequestObj); });
+    payloads.functor([]() { return sinceReset(PacketData); });
+    hostAllocs.functor([]() { return sinceReset(HostAllocs); });
+    slabBytes.functor([]() { return sinceReset(SlabBytes); });
+    remoteFrees.functor([]() { return sinceReset(RemoteFrees); });
+
+    hostAllocsPerObject = hostAllocs / (packets + requests + payloads);
+    hostAllocsPerObject.precision(4);
+}
+
+void
+PacketPoolStats::resetStats()
+{
+    for (unsigned counter = 0; counter < NumCounters; counter++)
+        resetCounts[counter] = sumCaches(counter);
+
+    statistics::Group::resetStats();
+}
+
+statistics::Group &
+stats()
+{
+    return poolStats;
+}
+
+} // namespace packet_pool
+} // namespace gem5
@@ -0,0 +1,92 @@
+#ifndef __MEM_PACKET_POOL_HH__
+#define __MEM_PACKET_POOL_HH__
+
+#include <cstddef>
+
+namespace gem5
+{
+
+namespace statistics
+{
+class Group;
+} // namespace statistics
+
+/**
+ * Slab allocator for the objects created for every memory transaction:
+ * Packets, Requests (with their shared_ptr control block) and packet
+ * payloads.
+ *
+ * Blocks come in a few size classes, the smallest one holds a 64-byte
+ * cache line. Every simulation thread keeps its own free list per class
+ * and refills it by carving a 64 KiB slab, so the common path takes no
+ * lock and composes with multi-eventq simulation. Each block carries a
+ * small header with its class and the thread that allocated it. A block
+ * freed by another thread goes onto a lock-free return list of its
+ * owner, which takes the list back before carving a new slab. Blocks
+ * allocated before the pool was enabled, and blocks larger than the
+ * biggest class, go back to the host allocator.
+ *
+ * The pool is off by default (Root.packet_pool). When it is off every
+ * allocation goes to the host allocator, but allocations are still
+ * counted, so packetPool.hostAllocs of a run with and without the pool
+ * shows the saving.
+ */
+namespace packet_pool
+{
+
+enum Kind
+{
+    PacketObj,
+    RequestObj,
+    PacketData,
+    NumKinds
+};
+
+/** Serve allocations from the free lists from now on. */
+void setEnabled(bool enabled);
+bool enabled();
+
+/**
+ * Allocate size bytes, aligned like ::operator new.
+ *
+ * @param kind What the block is for; only used for statistics.
+ */
+void *allocate(std::size_t size, Kind kind);
+
+/** Free a block from allocate(), on any thread. */
+void deallocate(void *p);
+
+/** Standard allocator on top of the pool, e.g. for std::allocate_shared. */
+template <typename T>
+struct Allocator
+{
+    using value_type = T;
+
+    Kind kind;
+
+    explicit Allocator(Kind _kind) : kind(_kind) {}
+
+    template <typename U>
+    Allocator(const Allocator<U> &other) : kind(other.kind) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        return static_cast<T *>(packet_pool::allocate(n * sizeof(T), kind));
+    }
+
+    void deallocate(T *p, std::size_t) { packet_pool::deallocate(p); }
+
+    template <typename U>
+    bool operator==(const Allocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const Allocator<U> &) const { return false; }
+};
+
+/** Global statistics, added to the root object as packetPool. */
+statistics::Group &stats();
+
+} // namespace packet_pool
+} // namespace gem5
+
+#endif // __MEM_PACKET_POOL_HH__
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/spsc_ring.hh"
+#include "base/statistics.hh"
+#include "mem/packet_pool.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+
+// statistics.cc looks formulas up through the root object, which this
+// test does not build
+Root *Root::_root = nullptr;
+
+namespace
+{
+
+/** Current value of one of the packetPool statistics. */
+uint64_t
+stat(const std::string &name)
+{
+    for (auto *info : packet_pool::stats().getStats()) {
+        if (info->name == name)
+            return dynamic_cast<statistics::ScalarInfo *>(info)->result();
+    }
+    ADD_FAILURE() << "no statistic " << name;
+    return 0;
+}
+
+/** Enable the pool for the lifetime of a test. */
+struct PoolEnabled
+{
+    PoolEnabled() { packet_pool::setEnabled(true); }
+    ~PoolEnabled() { packet_pool::setEnabled(false); }
+};
+
+} // anonymous namespace
+
+TEST(PacketPoolTest, ReuseOnSameThread)
+{
+    PoolEnabled enabled;
+
+    // Run on a fresh thread so its free lists start empty
+    std::thread([]() {
+        void *p = packet_pool::allocate(48, packet_pool::PacketObj);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) %
+                  alignof(std::max_align_t), 0);
+        std::memset(p, 0xa5, 48);
+        packet_pool::deallocate(p);
+
+        // Free lists are LIFO and classes round up to 64 bytes
+        EXPECT_EQ(packet_pool::allocate(64, packet_pool::PacketData), p);
+        packet_pool::deallocate(p);
+    }).join();
+}
+
+TEST(PacketPoolTest, FreeOnOtherThread)
+{
+    PoolEnabled enabled;
+
+    std::thread([]() {
+        // More blocks than a slab holds, so the second round needs a
+        // refill once the slab leftovers are used up
+        const int count = 1024;
+        std::vector<void *> blocks;
+        for (int i = 0; i < count; i++)
+            blocks.push_back(packet_pool::allocate(64,
+                                                   packet_pool::PacketObj));
+        const std::set<void *> first(blocks.begin(), blocks.end());
+
+        const uint64_t remote = stat("remoteFrees");
+        std::thread([&blocks]() {
+            for (void *p : blocks)
+                packet_pool::deallocate(p);
+        }).join();
+        EXPECT_EQ(stat("remoteFrees") - remote, count);
+
+        // The refill takes the returned blocks instead of a new slab
+        const uint64_t host = stat("hostAllocs");
+        int reused = 0;
+        for (int i = 0; i < count; i++) {
+            blocks[i] = packet_pool::allocate(64, packet_pool::PacketObj);
+            reused += first.count(blocks[i]);
+        }
+        EXPECT_EQ(stat("hostAllocs"), host);
+        EXPECT_GT(reused, 0);
+
+        for (void *p : blocks)
+            packet_pool::deallocate(p);
+    }).join();
+}
+
+TEST(PacketPoolTest, LargeBlocksFromHost)
+{
+    PoolEnabled enabled;
+
+    std::thread([]() {
+        const uint64_t host = stat("hostAllocs");
+        void *p = packet_pool::allocate(4096, packet_pool::PacketData);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) %
+                  alignof(std::max_align_t), 0);
+        std::memset(p, 0x5a, 4096);
+        EXPECT_EQ(stat("hostAllocs") - host, 1);
+
+        // Just above the biggest class
+        void *q = packet_pool::allocate(513, packet_pool::PacketData);
+        std::memset(q, 0x5a, 513);
+        EXPECT_EQ(stat("hostAllocs") - host, 2);
+
+        // Host blocks are not kept for later allocations
+        packet_pool::deallocate(p);
+        packet_pool::deallocate(q);
+        void *r = packet_pool::allocate(4096, packet_pool::PacketData);
+        EXPECT_EQ(stat("hostAllocs") - host, 3);
+        packet_pool::deallocate(r);
+    }).join();
+}
+
+TEST(PacketPoolTest, ToggleWithLiveBlocks)
+{
+    std::thread([]() {
+        // Allocated from the host before the pool is enabled: it must go
+        // back to the host, not onto a free list
+        packet_pool::setEnabled(false);
+        void *host = packet_pool::allocate(64, packet_pool::RequestObj);
+        packet_pool::setEnabled(true);
+        packet_pool::deallocate(host);
+
+        void *pooled = packet_pool::allocate(64, packet_pool::RequestObj);
+        EXPECT_NE(pooled, host);
+
+        // Allocated from the pool and freed while it is off: it goes
+        // back to its free list and is reused once the pool is on again
+        packet_pool::setEnabled(false);
+        packet_pool::deallocate(pooled);
+        packet_pool::setEnabled(true);
+        EXPECT_EQ(packet_pool::allocate(64, packet_pool::RequestObj), pooled);
+        packet_pool::deallocate(pooled);
+        packet_pool::setEnabled(false);
+    }).join();
+}
+
+TEST(PacketPoolTest, ProducerConsumer)
+{
+    PoolEnabled enabled;
+
+    // One thread allocates, the other frees, as when packets cross
+    // event queues. The returned blocks keep the producer from taking
+    // more slabs.
+    const uint64_t count = 1000000;
+    SpscRing<void *> ring(256);
+    const uint64_t slabs = stat("slabBytes");
+
+    std::thread producer([&ring, count]() {
+        for (uint64_t i = 0; i < count; i++) {
+            auto *p = static_cast<uint64_t *>(
+                packet_pool::allocate(sizeof(uint64_t) * (1 + i % 16),
+                                      packet_pool::PacketData));
+            *p = i;
+            while (!ring.push(p))
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t mismatches = 0;
+    while (expected < count) {
+        void *const *item = ring.front();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (*static_cast<uint64_t *>(*item) != expected)
+            mismatches++;
+        packet_pool::deallocate(*item);
+        ring.pop();
+        expected++;
+    }
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_LE(stat("slabBytes") - slabs, 16 * 64 * 1024);
+}
@@ -54,6 +54,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
@@ -63,6 +64,7 @@
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
+#include "mem/packet_pool.hh"
 #include "sim/cur_tick.hh"
 
 namespace gem5
@@ -94,6 +96,9 @@ class ThreadContext;
 typedef std::shared_ptr<Request> RequestPtr;
 typedef uint16_t RequestorID;
 
+template <typename... Args>
+RequestPtr makeRequest(Args&&... args);
+
 class Request : public Extensible<Request>
 {
   public:
@@ -530,6 +535,19 @@ class Request : public Extensible<Request>
 
     ~Request() {}
 
+    /** Requests are allocated from the memory pool, see packet_pool.hh. */
+    static void *
+    operator new(std::size_t size)
+    {
+        return packet_pool::allocate(size, packet_pool::RequestObj);
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        packet_pool::deallocate(p);
+    }
+
     /**
      * Factory method for creating memory management requests, with
      * unspecified addr and size.
@@ -537,7 +555,7 @@ class Request : public Extensible<Request>
     static RequestPtr
     createMemManagement(Flags flags, RequestorID id)
     {
-        auto mgmt_req = std::make_shared<Request>();
+        auto mgmt_req = makeRequest();
         mgmt_req->_flags.set(flags);
         mgmt_req->_requestorId = id;
         mgmt_req->_time = curTick();
@@ -619,8 +637,8 @@ class Request : public Extensible<Request>
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = makeRequest(*this);
+        req2 = makeRequest(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -1141,6 +1159,19 @@ class Request : public Extensible<Request>
     }
 };
 
+/**
+ * Create a Request like std::make_shared, with the Request and its
+ * reference count in one block from the memory pool.
+ */
+template <typename... Args>
+RequestPtr
+makeRequest(Args&&... args)
+{
+    return std::allocate_shared<Request>(
+        packet_pool::Allocator<Request>(packet_pool::RequestObj),
+        std::forward<Args>(args)...);
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
@@ -88,7 +88,8 @@ SimpleMemory::recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor)
     DPRINTF(Drain,"XWY, %s::recvAtomicBackdoor called! Addr = 0x%x\n", name().c_str(), pkt->getAddr());
     Tick latency = recvAtomic(pkt);
 
-    getBackdoor(_backdoor);
+    if (backdoorAllowed())
+        getBackdoor(_backdoor);
     return latency;
 }
 
@@ -114,7 +115,8 @@ void
 SimpleMemory::recvMemBackdoorReq(const MemBackdoorReq &req,
         MemBackdoorPtr &_backdoor)
 {
-    getBackdoor(_backdoor);
+    if (backdoorAllowed())
+        getBackdoor(_backdoor);
 }
 
 bool
@@ -164,6 +166,9 @@ SimpleMemory::recvTimingReq(PacketPtr pkt)
         isBusy = true;
     }
 
+    // any structural hazards of a derived memory delay the access
+    Tick access_delay = accessDelay(pkt);
+
     // go ahead and deal with the packet and put the response in the
     // queue if there is one
     bool needsResponse = pkt->needsResponse();
@@ -174,7 +179,8 @@ SimpleMemory::recvTimingReq(PacketPtr pkt)
         // atomic response
         assert(pkt->isResponse());
 
-        Tick when_to_send = curTick() + receive_delay + getLatency();
+        Tick when_to_send = curTick() + receive_delay + access_delay +
+            getLatency();
 
         // typically this should be added at the end, so start the
         // insertion sort with the last element, also make sure not to
@@ -288,6 +294,7 @@ SimpleMemory::MemoryPort::getAddrRanges() const
 Tick
 SimpleMemory::MemoryPort::recvAtomic(PacketPtr pkt)
 {
+    mem.atomicAccess(pkt);
     return mem.recvAtomic(pkt);
 }
 
@@ -295,6 +302,7 @@ Tick
 SimpleMemory::MemoryPort::recvAtomicBackdoor(
         PacketPtr pkt, MemBackdoorPtr &_backdoor)
 {
+    mem.atomicAccess(pkt);
     return mem.recvAtomicBackdoor(pkt, _backdoor);
 }
 
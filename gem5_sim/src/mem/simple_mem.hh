@@ -193,6 +193,33 @@ class SimpleMemory : public AbstractMemory
     void init() override;
 
   protected:
+    /**
+     * Additional delay a timing request sees before it can access the
+     * storage, e.g. due to bank conflicts in a derived memory. Called
+     * once for every accepted timing request.
+     *
+     * @param pkt the request being accepted
+     * @return the extra delay in ticks
+     */
+    virtual Tick accessDelay(PacketPtr pkt) { return 0; }
+
+    /**
+     * Called for every atomic request that arrives on the memory port.
+     * The timing path also goes through recvAtomic() but does not call
+     * this, so a derived memory can observe each access exactly once
+     * together with accessDelay().
+     *
+     * @param pkt the atomic request
+     */
+    virtual void atomicAccess(PacketPtr pkt) {}
+
+    /**
+     * Whether requestors may bypass the memory port through a backdoor.
+     * A derived memory that observes atomicAccess() withholds it, as
+     * accesses through the backdoor would not be seen.
+     */
+    virtual bool backdoorAllowed() const { return true; }
+
     Tick recvAtomic(PacketPtr pkt);
     Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor);
     void recvFunctional(PacketPtr pkt);
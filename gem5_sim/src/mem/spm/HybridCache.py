@@ -0,0 +1,59 @@
+from m5.params import *
+from m5.objects.Cache import Cache
+from m5.objects.Tags import BaseSetAssoc
+
+
+class HybridSetAssoc(BaseSetAssoc):
+    """Set-associative tags that only allocate in the first
+    getWayAllocationMax() ways, so the other ways can act as SPM."""
+
+    type = 'HybridSetAssoc'
+    cxx_header = "mem/spm/hybrid_cache.hh"
+    cxx_class = "gem5::HybridSetAssoc"
+
+
+class HybridCache(Cache):
+    """
+    L1D memory with a run-time cache/SPM split (docs/mem_hier_v0.md, 2.1)
+
+    One SRAM array backs the address window spm_range. The register at
+    cfg_addr (L1D_CACHE_VOL_CFG) selects how much of it is cache:
+    0 -> 0KB, 1 -> 4KB, 2 -> 8KB, 3 -> 16KB, 4 and above -> 32KB. The low
+    part of the window belongs to the cache ways, the rest is SPM and is
+    served locally. Writing the register writes back and invalidates the
+    cache. The cache size is the largest split; size / assoc must divide
+    4KiB so every split is a whole number of ways.
+
+    Any write to the register at flush_addr (L1D_CACHE_FLUSH) writes back
+    and invalidates the cache without changing the split. The IDMA does not
+    snoop the cache, so software writes it before the IDMA reads data the
+    CPU wrote through the cache, and after the IDMA wrote data the CPU then
+    reads through the cache. Register writes wait until no miss is
+    outstanding. Device registers must be mapped uncacheable in the page
+    table, e.g. process.map(..., cacheable=False).
+    """
+
+    type = 'HybridCache'
+    cxx_header = "mem/spm/hybrid_cache.hh"
+    cxx_class = "gem5::HybridCache"
+
+    size = '32KiB'
+    assoc = 8
+    tag_latency = 1
+    data_latency = 1
+    response_latency = 1
+    mshrs = 4
+    tgts_per_mshr = 8
+    tags = HybridSetAssoc()
+
+    spm_range = Param.AddrRange("Address window of the whole SRAM array")
+    cfg_addr = Param.Addr("Address of the L1D_CACHE_VOL_CFG register")
+    flush_addr = Param.Addr("Address of the L1D_CACHE_FLUSH register")
+    cache_vol_cfg = Param.Unsigned(4, "Initial L1D_CACHE_VOL_CFG value")
+    spm_latency = Param.Cycles(2, "Cycles of an SPM access")
+    reconfig_latency = Param.Cycles(100, "Cycles a write to "
+                                         "L1D_CACHE_VOL_CFG or "
+                                         "L1D_CACHE_FLUSH takes")
+
+    # IDMA 访问 SPM 部分的端口
+    dma_port = ResponsePort("DMA port for accessing the SPM part")
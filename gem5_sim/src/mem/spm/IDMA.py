@@ -1,8 +1,51 @@
 from m5.params import *
 from m5.objects.Device import DmaVirtDevice
+from m5.objects.IntPin import IntSourcePin
 
 class IDMA(DmaVirtDevice):
     type = 'IDMA'
     cxx_header = "mem/spm/idma.hh"
     cxx_class = "gem5::IDMA"
-    abstract = False
\ No newline at end of file
+    abstract = False
+
+    # 寄存器窗口：每个核心或簇各自的 IDMA 放在不同的 pio_addr
+    pio_addr = Param.Addr(0x80060000, "Base address of the register window")
+    pio_size = Param.Addr(0x1000, "Size of the register window")
+    pio_latency = Param.Cycles(1, "Latency of a register access")
+
+    # 描述符通道：每个通道独立遍历内存中的描述符链，
+    # 软件写一次通道的 DESC_HEAD 寄存器即可启动整条链
+    num_channels = Param.Unsigned(4, "Number of independent descriptor "
+                                     "channels")
+
+    # 流水化传输：按 burst 切分，每个 burst 读回后立即写出，
+    # 传输时间趋近 max(读, 写) 而不是二者之和
+    streaming = Param.Bool(True, "Forward each burst to the destination as "
+                           "soon as its read completes; if False, read the "
+                           "whole transfer before writing it")
+    # 每个 burst 作为一个 DMA 包发出，长度为 64B 到 4KB 的 2 的幂
+    burst_size = Param.Unsigned(64, "Bytes per burst and per DMA packet "
+                                    "(64-4096, power of two)")
+    max_inflight_bursts = Param.Unsigned(4, "Maximum number of outstanding "
+                                            "read bursts per transfer")
+    staging_fifo_depth = Param.Unsigned(8, "Number of burst-sized slots in "
+                                           "each transfer's staging FIFO")
+
+    # IOTLB：缓存发起核心地址空间的翻译，缺失时经该核心的 MMU 遍历页表
+    iotlb_entries = Param.Unsigned(16, "Number of IOTLB entries (4KiB "
+                                       "pages); 0 walks on every access")
+    iotlb_hit_latency = Param.Cycles(1, "IOTLB lookup latency")
+    iotlb_walk_latency = Param.Cycles(20, "Page table walk latency on an "
+                                          "IOTLB miss")
+
+    # 别名译码：页表把别名原样映射时，翻译后的地址用发起核心自己的
+    # SpmAliasMapper 换成真名，alias_cpus[i] 对应 alias_mappers[i]
+    alias_mappers = VectorParam.SpmAliasMapper(
+        [], "Alias decoders of the cores that start transfers")
+    alias_cpus = VectorParam.BaseCPU(
+        [], "Cores whose transfers use the alias_mappers of the same index")
+
+    # 完成中断：INT_STATUS & INT_ENABLE 非零时拉高，
+    # 可直接连到 RISC-V 中断控制器的 local_interrupt_pins
+    int_pin = IntSourcePin("Raised while an enabled completion interrupt "
+                           "is pending")
@@ -57,3 +57,25 @@ class ScratchpadMemory(SimpleMemory):
     # MMR is accessed through the main port (inherited from SimpleMemory)
     # MMR region is located at the end of the SPM address range
     mmr_size = Param.Addr(0x100, "Size of the MMR region in bytes (default 256 bytes)")
+
+    # SRAM bank model shared by the CPU port and the DMA port. Consecutive
+    # bank_width-byte words are interleaved across num_banks single-ported
+    # banks (8 x 1-word banks in docs/mem_hier_v0.md); an access waits for
+    # every bank it touches and keeps each one busy for bank_latency cycles
+    # per word.
+    num_banks = Param.Unsigned(8, "Number of interleaved SRAM banks")
+    bank_width = Param.Unsigned(4, "Bytes per bank word (interleaving "
+                                   "granularity)")
+    bank_latency = Param.Cycles(1, "Cycles a bank is busy per word access")
+    dma_priority = Param.Bool(False, "Give DMA accesses priority over CPU "
+                                     "accesses on bank conflicts")
+
+    # Responses of the dma_port wait in a bounded queue until their ready
+    # time. When it is full the port refuses new requests and sends a retry
+    # once a response has left, which bounds the outstanding DMA
+    # transactions. With dma_resp_reorder responses leave in ready-time
+    # order rather than arrival order.
+    dma_resp_queue_depth = Param.Unsigned(16, "Maximum number of queued "
+                                              "DMA responses")
+    dma_resp_reorder = Param.Bool(False, "Send DMA responses in ready-time "
+                                         "order")
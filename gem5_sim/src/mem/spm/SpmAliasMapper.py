@@ -0,0 +1,48 @@
+from m5.params import *
+from m5.objects.AddrMapper import AddrMapper
+
+
+class SpmAliasMapper(AddrMapper):
+    """
+    Alias decoder between a core and its cluster crossbar
+    (docs/mem_hier_v0.md 1.3)
+
+    The defaults match configs/spm/cluster.py: each cluster has a 16MiB
+    real-name window starting at cluster_base, with core k's L1I/L1D at
+    k * core_stride and the L2 SPM at l2_offset. A window of size 0
+    disables that alias.
+    """
+
+    type = 'SpmAliasMapper'
+    cxx_header = "mem/spm/spm_alias_mapper.hh"
+    cxx_class = "gem5::SpmAliasMapper"
+
+    cluster_id = Param.Unsigned("Cluster of the requestor")
+    core_id = Param.Unsigned(0, "Core of the requestor within its cluster")
+    num_clusters = Param.Unsigned(8, "Number of clusters")
+
+    # 真名地址布局
+    cluster_base = Param.Addr(0x1_0000_0000, "Real address of cluster 0")
+    cluster_stride = Param.Addr(0x100_0000, "Real address window of one "
+                                            "cluster (power of two)")
+    core_stride = Param.Addr(0x2_0000, "L1 SPM window of one core in a "
+                                       "cluster")
+    l2_offset = Param.Addr(0x10_0000, "Offset of the L2 SPM in a cluster "
+                                      "window")
+
+    # 核别名：本核心的 L1I/L1D SPM
+    self_alias = Param.AddrRange(AddrRange(start=0x80000000, size=0x2_0000),
+                                 "Alias of the requestor's own L1 SPMs")
+    # 簇别名：本簇的 L2 SPM
+    l2_alias = Param.AddrRange(AddrRange(start=0x80020000, size=0x4_0000),
+                               "Alias of the own cluster's L2 SPM")
+    # 簇中核真名：本簇的整个窗口，可访问簇内其他核心的 L1 SPM
+    cluster_alias = Param.AddrRange(
+        AddrRange(start=0x81000000, size=0x100_0000),
+        "Alias of the own cluster's real-name window")
+    # 簇真名：所有簇的 L2 SPM，每个簇占 global_stride
+    global_alias = Param.AddrRange(
+        AddrRange(start=0x88000000, size=8 * 0x4_0000),
+        "Alias of the L2 SPM of every cluster")
+    global_stride = Param.Addr(0x4_0000, "Stride between clusters in the "
+                                         "global alias (power of two)")
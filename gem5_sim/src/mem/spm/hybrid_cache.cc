@@ -0,0 +1,356 @@
+#include "mem/spm/hybrid_cache.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "debug/HybridCache.hh"
+#include "mem/packet_access.hh"
+
+namespace gem5
+{
+
+HybridSetAssoc::HybridSetAssoc(const Params &p)
+    : BaseSetAssoc(p)
+{
+}
+
+void
+HybridSetAssoc::setWayAllocationMax(int ways)
+{
+    // 0 路表示缓存部分为 0KB，此时不分配任何缓存行
+    fatal_if(ways < 0, "Allocation limit must not be negative");
+    allocAssoc = ways;
+}
+
+CacheBlk *
+HybridSetAssoc::findVictim(const CacheBlk::KeyType &key,
+                           const std::size_t size,
+                           std::vector<CacheBlk *> &evict_blks,
+                           const uint64_t partition_id)
+{
+    std::vector<ReplaceableEntry *> entries =
+        indexingPolicy->getPossibleEntries(key);
+
+    // 只在当前分给缓存的路里选择替换对象
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [this](const ReplaceableEntry *entry) {
+            return entry->getWay() >= allocAssoc;
+        }), entries.end());
+
+    if (partitionManager) {
+        partitionManager->filterByPartition(entries, partition_id);
+    }
+
+    CacheBlk *victim = entries.empty() ? nullptr :
+        static_cast<CacheBlk *>(replacementPolicy->getVictim(entries));
+
+    // 没有可用的路时返回空，填充只经过 tempBlock，不留在缓存里
+    if (victim)
+        evict_blks.push_back(victim);
+    return victim;
+}
+
+HybridCache::SpmDmaPort::SpmDmaPort(const std::string &_name,
+                                    HybridCache &_owner)
+    : QueuedResponsePort(_name, queue), queue(_owner, *this),
+      owner(_owner)
+{
+}
+
+AddrRangeList
+HybridCache::SpmDmaPort::getAddrRanges() const
+{
+    return { owner.spmRange };
+}
+
+Tick
+HybridCache::SpmDmaPort::recvAtomic(PacketPtr pkt)
+{
+    return owner.cyclesToTicks(owner.accessLocal(pkt));
+}
+
+bool
+HybridCache::SpmDmaPort::recvTimingReq(PacketPtr pkt)
+{
+    bool needs_response = pkt->needsResponse();
+    Cycles lat = owner.accessLocal(pkt);
+    if (needs_response)
+        schedTimingResp(pkt, owner.clockEdge(lat));
+    else
+        owner.pendingDelete.reset(pkt);
+    return true;
+}
+
+void
+HybridCache::SpmDmaPort::recvFunctional(PacketPtr pkt)
+{
+    if (!queue.trySatisfyFunctional(pkt))
+        owner.accessLocal(pkt);
+}
+
+HybridCache::HybridCache(const Params &p)
+    : Cache(p),
+      dmaPort(name() + ".dma_port", *this),
+      spmRange(p.spm_range),
+      cfgAddr(p.cfg_addr),
+      flushAddr(p.flush_addr),
+      spmLatency(p.spm_latency),
+      reconfigLatency(p.reconfig_latency),
+      maxCacheBytes(p.size),
+      wayBytes(p.size / p.assoc),
+      cacheVolCfg(p.cache_vol_cfg),
+      cacheBytes(0),
+      spmData(p.spm_range.size(), 0),
+      pendingRegWrite(nullptr),
+      regWriteEvent([this]{ retryRegWrite(); }, name() + ".regWriteEvent"),
+      hybridStats(*this)
+{
+    fatal_if(!dynamic_cast<HybridSetAssoc *>(tags),
+             "%s: tags must be HybridSetAssoc to restrict the cache ways\n",
+             name());
+    fatal_if(spmRange.interleaved(),
+             "%s: spm_range must not be interleaved\n", name());
+    fatal_if(maxCacheBytes > spmRange.size(),
+             "%s: cache size %d exceeds the %d-byte SRAM window\n",
+             name(), maxCacheBytes, spmRange.size());
+    fatal_if(spmRange.contains(cfgAddr),
+             "%s: cfg_addr %#x lies inside spm_range\n", name(), cfgAddr);
+    fatal_if(spmRange.contains(flushAddr),
+             "%s: flush_addr %#x lies inside spm_range\n", name(),
+             flushAddr);
+    fatal_if(flushAddr == cfgAddr,
+             "%s: flush_addr and cfg_addr are both %#x\n", name(), cfgAddr);
+    for (uint32_t cfg = 1; cfg <= 4; cfg++) {
+        fatal_if(cacheBytesForCfg(cfg) % wayBytes,
+                 "%s: a %d-byte cache is not a whole number of %d-byte "
+                 "ways, increase assoc\n", name(), cacheBytesForCfg(cfg),
+                 wayBytes);
+    }
+
+    // 初始划分时缓存为空，不需要写回
+    cacheBytes = cacheBytesForCfg(cacheVolCfg);
+    tags->setWayAllocationMax(cacheBytes / wayBytes);
+}
+
+Port &
+HybridCache::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "dma_port")
+        return dmaPort;
+    return Cache::getPort(if_name, idx);
+}
+
+void
+HybridCache::init()
+{
+    Cache::init();
+    if (dmaPort.isConnected())
+        dmaPort.sendRangeChange();
+}
+
+unsigned
+HybridCache::cacheBytesForCfg(uint32_t cfg) const
+{
+    // 000 -> 0KB, 001 -> 4KB, 010 -> 8KB, 011 -> 16KB, 100 及以上 -> 32KB
+    unsigned bytes = cfg == 0 ? 0 : 0x1000u << (std::min(cfg, 4u) - 1);
+    return std::min(bytes, maxCacheBytes);
+}
+
+void
+HybridCache::reconfigure(uint32_t cfg)
+{
+    unsigned bytes = cacheBytesForCfg(cfg);
+    cacheVolCfg = cfg;
+    if (bytes == cacheBytes)
+        return;
+
+    DPRINTF(HybridCache, "L1D_CACHE_VOL_CFG %d: cache %d -> %d bytes\n",
+            cfg, cacheBytes, bytes);
+
+    // 先写回并作废所有缓存行，再改变可分配的路数
+    flush();
+    tags->setWayAllocationMax(bytes / wayBytes);
+
+    // 交还给 SPM 的区域内容未定义，这里清零
+    if (bytes < cacheBytes) {
+        std::fill(spmData.begin() + bytes, spmData.begin() + cacheBytes, 0);
+    }
+    cacheBytes = bytes;
+    hybridStats.reconfigurations++;
+}
+
+void
+HybridCache::flush()
+{
+    // recvTimingReq 会把寄存器写推迟到队列排空之后
+    panic_if(!mshrQueue.isEmpty() || !writeBuffer.isEmpty(),
+             "%s: cache flushed with misses outstanding\n", name());
+    memWriteback();
+    memInvalidate();
+}
+
+Cycles
+HybridCache::accessLocal(PacketPtr pkt)
+{
+    bool needs_response = pkt->needsResponse();
+
+    if (pkt->getAddr() == cfgAddr) {
+        panic_if(pkt->getSize() != sizeof(uint32_t),
+                 "Invalid access size for L1D_CACHE_VOL_CFG: %d\n",
+                 pkt->getSize());
+        Cycles lat = spmLatency;
+        if (pkt->isRead()) {
+            pkt->setLE<uint32_t>(cacheVolCfg);
+        } else if (pkt->isWrite()) {
+            reconfigure(pkt->getLE<uint32_t>());
+            lat = reconfigLatency;
+        }
+        if (needs_response)
+            pkt->makeResponse();
+        return lat;
+    }
+
+    if (pkt->getAddr() == flushAddr) {
+        panic_if(pkt->getSize() != sizeof(uint32_t),
+                 "Invalid access size for L1D_CACHE_FLUSH: %d\n",
+                 pkt->getSize());
+        Cycles lat = spmLatency;
+        if (pkt->isRead()) {
+            pkt->setLE<uint32_t>(0);
+        } else if (pkt->isWrite()) {
+            // 写入任意值都会写回并作废整个缓存
+            DPRINTF(HybridCache, "L1D_CACHE_FLUSH\n");
+            flush();
+            hybridStats.flushes++;
+            lat = reconfigLatency;
+        }
+        if (needs_response)
+            pkt->makeResponse();
+        return lat;
+    }
+
+    Addr offset = pkt->getAddr() - spmRange.start();
+    if (offset < cacheBytes || offset + pkt->getSize() > spmRange.size()) {
+        // 这部分 SRAM 当前属于缓存
+        warn("%s: %s to %#x is outside the %d-byte SPM part\n", name(),
+             pkt->cmdString(), pkt->getAddr(), spmRange.size() - cacheBytes);
+        hybridStats.spmBadAccesses++;
+        if (needs_response) {
+            pkt->makeResponse();
+            pkt->setBadAddress();
+        }
+        return spmLatency;
+    }
+
+    hybridStats.spmAccesses++;
+    uint8_t *host_addr = spmData.data() + offset;
+    if (pkt->cmd == MemCmd::SwapReq) {
+        panic_if(!pkt->isAtomicOp(),
+                 "%s: only AMO swaps are supported on the SPM\n", name());
+        pkt->setData(host_addr);
+        (*(pkt->getAtomicOp()))(host_addr);
+    } else if (pkt->isRead()) {
+        pkt->setData(host_addr);
+    } else if (pkt->isWrite()) {
+        // SPM 不跟踪 LR 预约，SC 总是成功
+        if (pkt->isLLSC())
+            pkt->req->setExtraData(1);
+        pkt->writeData(host_addr);
+    }
+
+    if (needs_response)
+        pkt->makeResponse();
+    return spmLatency;
+}
+
+void
+HybridCache::respondLocal(PacketPtr pkt)
+{
+    bool needs_response = pkt->needsResponse();
+    Cycles lat = accessLocal(pkt);
+    if (needs_response)
+        cpuSidePort.schedTimingResp(pkt, clockEdge(lat));
+    else
+        pendingDelete.reset(pkt);
+}
+
+void
+HybridCache::retryRegWrite()
+{
+    assert(pendingRegWrite);
+    if (!mshrQueue.isEmpty() || !writeBuffer.isEmpty()) {
+        schedule(regWriteEvent, clockEdge(Cycles(1)));
+        return;
+    }
+
+    PacketPtr pkt = pendingRegWrite;
+    pendingRegWrite = nullptr;
+    respondLocal(pkt);
+    clearBlocked(Blocked_Reconfig);
+}
+
+void
+HybridCache::recvTimingReq(PacketPtr pkt)
+{
+    if (isRegAddr(pkt->getAddr()) && pkt->isWrite() &&
+        (!mshrQueue.isEmpty() || !writeBuffer.isEmpty())) {
+        // 写回和作废要等未完成的缺失和写回结束，期间不再接收新请求
+        DPRINTF(HybridCache, "Write to %#x waits for the queues to drain\n",
+                pkt->getAddr());
+        assert(!pendingRegWrite);
+        pendingRegWrite = pkt;
+        setBlocked(Blocked_Reconfig);
+        schedule(regWriteEvent, clockEdge(Cycles(1)));
+        return;
+    }
+
+    if (isRegAddr(pkt->getAddr()) || isSpmAddr(pkt->getAddr())) {
+        respondLocal(pkt);
+        return;
+    }
+
+    Cache::recvTimingReq(pkt);
+}
+
+Tick
+HybridCache::recvAtomic(PacketPtr pkt)
+{
+    if (isRegAddr(pkt->getAddr()) || isSpmAddr(pkt->getAddr()))
+        return cyclesToTicks(accessLocal(pkt));
+
+    return Cache::recvAtomic(pkt);
+}
+
+void
+HybridCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
+{
+    if (from_cpu_side && isSpmAddr(pkt->getAddr())) {
+        accessLocal(pkt);
+        return;
+    }
+    if (from_cpu_side && isRegAddr(pkt->getAddr())) {
+        // 功能访问不触发重新划分或冲刷
+        if (pkt->isRead())
+            pkt->setLE<uint32_t>(pkt->getAddr() == cfgAddr ? cacheVolCfg : 0);
+        pkt->makeResponse();
+        return;
+    }
+    Cache::functionalAccess(pkt, from_cpu_side);
+}
+
+HybridCache::HybridCacheStats::HybridCacheStats(HybridCache &cache)
+    : statistics::Group(&cache),
+      ADD_STAT(spmAccesses, statistics::units::Count::get(),
+               "Number of accesses served by the SPM part"),
+      ADD_STAT(spmBadAccesses, statistics::units::Count::get(),
+               "Number of accesses to the part of the window owned by "
+               "the cache"),
+      ADD_STAT(reconfigurations, statistics::units::Count::get(),
+               "Number of writes to L1D_CACHE_VOL_CFG that changed the "
+               "cache/SPM split"),
+      ADD_STAT(flushes, statistics::units::Count::get(),
+               "Number of writes to L1D_CACHE_FLUSH")
+{
+}
+
+} // namespace gem5
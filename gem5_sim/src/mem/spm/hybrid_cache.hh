@@ -0,0 +1,172 @@
+#ifndef __MEM_SPM_HYBRID_CACHE_HH__
+#define __MEM_SPM_HYBRID_CACHE_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/cache.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "mem/packet_queue.hh"
+#include "mem/qport.hh"
+#include "sim/eventq.hh"
+#include "params/HybridCache.hh"
+#include "params/HybridSetAssoc.hh"
+
+namespace gem5
+{
+
+/**
+ * Set-associative tags that only pick victims among the first
+ * getWayAllocationMax() ways. BaseSetAssoc stores the limit but does not
+ * apply it; HybridCache relies on it to give the remaining ways to the SPM.
+ * The limit may be zero, then nothing is allocated and fills only pass
+ * through the temporary block.
+ */
+class HybridSetAssoc : public BaseSetAssoc
+{
+  public:
+    PARAMS(HybridSetAssoc);
+    HybridSetAssoc(const Params &p);
+
+    void setWayAllocationMax(int ways) override;
+
+    CacheBlk *findVictim(const CacheBlk::KeyType &key,
+                         const std::size_t size,
+                         std::vector<CacheBlk *> &evict_blks,
+                         const uint64_t partition_id=0) override;
+};
+
+/**
+ * L1D memory of docs/mem_hier_v0.md: one SRAM array that is split at run
+ * time between a set-associative cache and a scratchpad.
+ *
+ * The array backs the address window spm_range. L1D_CACHE_VOL_CFG selects
+ * how much of it is cache (0, 4, 8, 16 or 32 KiB, larger codes saturate);
+ * the low part of the window then belongs to the cache ways and the rest is
+ * SPM. CPU accesses to the SPM part and to the registers are served
+ * locally, everything else goes through the cache. Writing
+ * L1D_CACHE_VOL_CFG writes back and invalidates the cache before the split
+ * changes; writing L1D_CACHE_FLUSH only writes back and invalidates. Both
+ * writes wait until the outstanding misses and writebacks have drained,
+ * and the cache accepts no other request meanwhile.
+ */
+class HybridCache : public Cache
+{
+  protected:
+    /** Scratchpad access from the IDMA, like ScratchpadMemory::dma_port */
+    class SpmDmaPort : public QueuedResponsePort
+    {
+      private:
+        RespPacketQueue queue;
+        HybridCache &owner;
+
+      public:
+        SpmDmaPort(const std::string &name, HybridCache &owner);
+
+      protected:
+        AddrRangeList getAddrRanges() const override;
+        Tick recvAtomic(PacketPtr pkt) override;
+        bool recvTimingReq(PacketPtr pkt) override;
+        void recvFunctional(PacketPtr pkt) override;
+    };
+
+    SpmDmaPort dmaPort;
+
+    /** Address window of the whole SRAM array */
+    const AddrRange spmRange;
+    /** Address of the L1D_CACHE_VOL_CFG register */
+    const Addr cfgAddr;
+    /** Address of the L1D_CACHE_FLUSH register */
+    const Addr flushAddr;
+    /** Cycles of an SPM access */
+    const Cycles spmLatency;
+    /** Cycles a write to L1D_CACHE_VOL_CFG or L1D_CACHE_FLUSH takes */
+    const Cycles reconfigLatency;
+
+    /** Largest cache portion, i.e. the size of the tag store */
+    const unsigned maxCacheBytes;
+    /** Bytes covered by one cache way */
+    const unsigned wayBytes;
+
+    /** Current L1D_CACHE_VOL_CFG value and the resulting split */
+    uint32_t cacheVolCfg;
+    unsigned cacheBytes;
+
+    /** Backing store of the SRAM array, indexed by window offset */
+    std::vector<uint8_t> spmData;
+
+    /** Register write waiting for the MSHRs and write buffer to drain */
+    PacketPtr pendingRegWrite;
+    /** Checks every cycle whether pendingRegWrite can be applied */
+    EventFunctionWrapper regWriteEvent;
+
+    struct HybridCacheStats : public statistics::Group
+    {
+        HybridCacheStats(HybridCache &cache);
+
+        /** SPM accesses from the CPU and the DMA port */
+        statistics::Scalar spmAccesses;
+        /** Accesses to the part of the window owned by the cache */
+        statistics::Scalar spmBadAccesses;
+        /** Writes to L1D_CACHE_VOL_CFG that changed the split */
+        statistics::Scalar reconfigurations;
+        /** Writes to L1D_CACHE_FLUSH */
+        statistics::Scalar flushes;
+    } hybridStats;
+
+    /** Cache bytes selected by a L1D_CACHE_VOL_CFG code */
+    unsigned cacheBytesForCfg(uint32_t cfg) const;
+
+    /** Apply a new L1D_CACHE_VOL_CFG value */
+    void reconfigure(uint32_t cfg);
+
+    /** Write back and invalidate every cache line */
+    void flush();
+
+    /** Whether an address is one of the registers */
+    bool
+    isRegAddr(Addr addr) const
+    {
+        return addr == cfgAddr || addr == flushAddr;
+    }
+
+    /** Whether an address is in the SPM part of the window */
+    bool
+    isSpmAddr(Addr addr) const
+    {
+        return spmRange.contains(addr);
+    }
+
+    /**
+     * Serve an access to the SRAM window or a register and turn it into a
+     * response if it needs one.
+     *
+     * @return Cycles the access takes
+     */
+    Cycles accessLocal(PacketPtr pkt);
+
+    /** Serve a timing access locally and schedule its response */
+    void respondLocal(PacketPtr pkt);
+
+    /**
+     * Apply pendingRegWrite once no miss or writeback is outstanding,
+     * otherwise check again in the next cycle.
+     */
+    void retryRegWrite();
+
+    void recvTimingReq(PacketPtr pkt) override;
+    Tick recvAtomic(PacketPtr pkt) override;
+    void functionalAccess(PacketPtr pkt, bool from_cpu_side) override;
+
+  public:
+    PARAMS(HybridCache);
+    HybridCache(const Params &p);
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+    void init() override;
+};
+
+} // namespace gem5
+
+#endif // __MEM_SPM_HYBRID_CACHE_HH__
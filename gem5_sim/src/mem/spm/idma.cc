@@ -1,46 +1,226 @@
 #include "idma.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "cpu/base.hh"
+#include "cpu/thread_context.hh"
 #include "mem/packet_access.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
 #include "debug/IDMA.hh"
-#include "sim/full_system.hh"
-#include "sim/process.hh"
+#include "sim/faults.hh"
+#include "sim/stats.hh"
+#include "sim/system.hh"
 
 namespace gem5 {
 
 IDMA::IDMA(const Params &p) 
     : DmaVirtDevice(p),
-      regBase(0x80060000),  // 寄存器基地址，可以从参数中获取
+      regBase(p.pio_addr),
+      regSize(p.pio_size),
+      pioLatency(p.pio_latency),
       srcAddrReg(0),
       dstAddrReg(0),
       sizeReg(0),
       commandReg(0),
-      statusReg(0)
+      statusReg(0),
+      intStatusReg(0),
+      intEnableReg(0),
+      streaming(p.streaming),
+      burstSize(p.burst_size),
+      maxInflightBursts(p.max_inflight_bursts),
+      stagingDepth(p.staging_fifo_depth),
+      channels(p.num_channels),
+      chainStart(p.num_channels, 0),
+      iotlb(p.iotlb_entries),
+      iotlbHitLatency(p.iotlb_hit_latency),
+      iotlbWalkLatency(p.iotlb_walk_latency),
+      aliasMappers(p.alias_mappers),
+      aliasCpus(p.alias_cpus),
+      stats(*this)
 {
-    dmaBuffer = new uint8_t[1024 * 1024];
+    fatal_if(aliasMappers.size() != aliasCpus.size(),
+             "%s: alias_mappers and alias_cpus differ in length\n",
+             name());
+    fatal_if(REG_CH_BASE + channels.size() * REG_CH_STRIDE > regSize,
+             "%s: %d channels do not fit in the %d-byte register window\n",
+             name(), channels.size(), regSize);
+    fatal_if(channels.size() > 31,
+             "%s: at most 31 channels have a completion interrupt bit\n",
+             name());
+    fatal_if(maxInflightBursts == 0 || stagingDepth == 0,
+             "%s: max_inflight_bursts and staging_fifo_depth must be "
+             "non-zero\n", name());
+    fatal_if(!isPowerOf2(burstSize) || burstSize < 64 || burstSize > 4096,
+             "%s: burst_size must be a power of two from 64 to 4096, "
+             "got %d\n", name(), burstSize);
+
+    // 每个 burst 作为一个包发出，而不是再按缓存行切分
+    dmaPort.setChunkSize(burstSize);
+
+    for (int i = 0; i < p.port_int_pin_connection_count; i++) {
+        intPins.emplace_back(new IntSourcePin<IDMA>(
+            csprintf("%s.int_pin[%d]", name(), i), i, this));
+    }
 }
 
-IDMA::~IDMA() {
-    if (dmaBuffer) {
-        delete[] dmaBuffer;
+Port &
+IDMA::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "int_pin" && idx != InvalidPortID &&
+        idx < intPins.size()) {
+        return *intPins[idx];
     }
+    return DmaVirtDevice::getPort(if_name, idx);
 }
 
 TranslationGenPtr
 IDMA::translate(Addr vaddr, Addr size)
 {
-    if (!FullSystem) {
-        // Syscall-emulation 模式下，使用进程页表做虚实地址转换
-        auto process = sys->threads[0]->getProcessPtr();
-        return process->pTable->translateRange(vaddr, size);
+    // dmaXlate() 已经把用到的页装入 IOTLB，这里按发起核心的地址空间翻译
+    return TranslationGenPtr(new IotlbTranslationGen(
+        *this, xlateCtx, xlateMode, vaddr, size));
+}
+
+void
+IDMA::IotlbTranslationGen::translate(Range &range) const
+{
+    Addr next = roundUp(range.vaddr + 1, IOTLB_PAGE_SIZE);
+    range.size = std::min(range.size, next - range.vaddr);
+
+    Addr offset = range.vaddr & (IOTLB_PAGE_SIZE - 1);
+    IotlbEntry *entry = idma.iotlbProbe(ctx, range.vaddr >> IOTLB_PAGE_SHIFT);
+    if (entry) {
+        range.paddr = (entry->ppn << IOTLB_PAGE_SHIFT) | offset;
+    } else {
+        // IOTLB 容量不足以容纳一个请求的所有页时，剩余的页直接遍历
+        range.fault = idma.iotlbWalk(ctx, range.vaddr, mode, range.paddr);
+        if (range.fault != NoFault)
+            return;
+    }
+
+    // 别名窗口按页对齐，页内的一段译码后仍然连续
+    range.paddr = idma.decodeAlias(ctx, range.paddr);
+}
+
+Addr
+IDMA::decodeAlias(ContextID ctx, Addr paddr) const
+{
+    if (aliasMappers.empty())
+        return paddr;
+
+    // 按 cpu_id 匹配，切换 CPU 后接管线程的新 CPU 也能找到译码器
+    int cpu_id = sys->threads[ctx]->cpuId();
+    for (size_t i = 0; i < aliasCpus.size(); i++) {
+        if (aliasCpus[i]->cpuId() == cpu_id)
+            return aliasMappers[i]->decode(paddr);
+    }
+    return paddr;
+}
+
+IDMA::IotlbEntry *
+IDMA::iotlbProbe(ContextID ctx, Addr vpn)
+{
+    for (auto &entry : iotlb) {
+        if (entry.valid && entry.ctx == ctx && entry.vpn == vpn)
+            return &entry;
     }
+    return nullptr;
+}
+
+Fault
+IDMA::iotlbWalk(ContextID ctx, Addr vaddr, BaseMMU::Mode mode, Addr &paddr)
+{
+    fatal_if(ctx < 0 || ctx >= sys->threads.size(),
+             "%s: no thread context %d to translate %#x for\n",
+             name(), ctx, vaddr);
+    ThreadContext *tc = sys->threads[ctx];
 
-    // FullSystem 模式目前未实现 IDMA 的地址翻译
-    panic("IDMA::translate not implemented for full-system mode.\n");
+    auto req = makeRequest(vaddr, 1, 0, Request::funcRequestorId, 0, ctx);
+    Fault fault = tc->getMMUPtr()->translateFunctional(req, tc, mode);
+    if (fault == NoFault)
+        paddr = req->getPaddr();
+    return fault;
+}
+
+Tick
+IDMA::iotlbAccess(ContextID ctx, Addr vaddr, Addr size, BaseMMU::Mode mode)
+{
+    Tick when = curTick();
+    Addr first = vaddr >> IOTLB_PAGE_SHIFT;
+    Addr last = (vaddr + size - 1) >> IOTLB_PAGE_SHIFT;
+
+    for (Addr vpn = first; vpn <= last; vpn++) {
+        IotlbEntry *entry = iotlbProbe(ctx, vpn);
+        if (entry) {
+            stats.iotlbHits++;
+            entry->lastUse = ++iotlbUseCount;
+            when = std::max(when + cyclesToTicks(iotlbHitLatency),
+                            entry->ready);
+            continue;
+        }
+
+        // 缺失的页依次遍历页表
+        stats.iotlbMisses++;
+        when += cyclesToTicks(iotlbHitLatency + iotlbWalkLatency);
+
+        Addr paddr;
+        Addr page_vaddr = std::max(vaddr, vpn << IOTLB_PAGE_SHIFT);
+        if (iotlb.empty() ||
+            iotlbWalk(ctx, page_vaddr, mode, paddr) != NoFault) {
+            // 翻译失败的页不缓存，由 dmaVirt 报告错误
+            continue;
+        }
+
+        auto victim = std::min_element(iotlb.begin(), iotlb.end(),
+            [](const IotlbEntry &a, const IotlbEntry &b) {
+                if (a.valid != b.valid)
+                    return !a.valid;
+                return a.lastUse < b.lastUse;
+            });
+        victim->valid = true;
+        victim->ctx = ctx;
+        victim->vpn = vpn;
+        victim->ppn = paddr >> IOTLB_PAGE_SHIFT;
+        victim->lastUse = ++iotlbUseCount;
+        victim->ready = when;
+        DPRINTF(IDMA, "IOTLB fill: ctx %d vpn %#x -> ppn %#x\n",
+                ctx, vpn, victim->ppn);
+    }
+
+    stats.translationCycles += ticksToCycles(when - curTick());
+    return when - curTick();
+}
+
+void
+IDMA::iotlbFlush()
+{
+    DPRINTF(IDMA, "IOTLB flush\n");
+    for (auto &entry : iotlb)
+        entry.valid = false;
+    stats.iotlbFlushes++;
+}
+
+void
+IDMA::dmaXlate(BaseMMU::Mode mode, ContextID ctx, Addr vaddr,
+               unsigned size, DmaCallback *cb, void *data)
+{
+    Tick delay = iotlbAccess(ctx, vaddr, size, mode);
+
+    xlateCtx = ctx;
+    xlateMode = mode;
+    if (mode == BaseMMU::Write)
+        dmaWriteVirt(vaddr, size, cb, data, delay);
+    else
+        dmaReadVirt(vaddr, size, cb, data, delay);
 }
 
 AddrRangeList IDMA::getAddrRanges() const {
     AddrRangeList ranges;
-    // 返回寄存器地址范围（例如：4KB 的寄存器空间）
-    ranges.push_back(RangeSize(regBase, 0x1000));
+    // 返回寄存器地址范围
+    ranges.push_back(RangeSize(regBase, regSize));
     return ranges;
 }
 
@@ -55,6 +235,14 @@ Tick IDMA::read(PacketPtr pkt) {
     Addr offset = addr - regBase;
     DPRINTF(IDMA,"XWY, I've received ReadRequest from 0x%x, offset: %x\n", pkt->getAddr(), offset);
 
+    // 通道寄存器窗口单独译码
+    if (offset >= REG_CH_BASE &&
+        offset < REG_CH_BASE + channels.size() * REG_CH_STRIDE) {
+        Addr ch_offset = offset - REG_CH_BASE;
+        return readChannelReg(ch_offset / REG_CH_STRIDE,
+                              ch_offset % REG_CH_STRIDE, pkt);
+    }
+
     // 3. 根据偏移地址读取相应的寄存器
     switch (offset) {
       case REG_STATUS_OFFSET:
@@ -101,6 +289,22 @@ Tick IDMA::read(PacketPtr pkt) {
             panic("Invalid access size for COMMAND register: %d\n", pkt->getSize());
         }
         break;
+
+      case REG_INT_STATUS_OFFSET:
+        if (pkt->getSize() == sizeof(uint32_t)) {
+            pkt->setLE<uint32_t>(intStatusReg);
+        } else {
+            panic("Invalid access size for INT_STATUS register: %d\n", pkt->getSize());
+        }
+        break;
+
+      case REG_INT_ENABLE_OFFSET:
+        if (pkt->getSize() == sizeof(uint32_t)) {
+            pkt->setLE<uint32_t>(intEnableReg);
+        } else {
+            panic("Invalid access size for INT_ENABLE register: %d\n", pkt->getSize());
+        }
+        break;
         
       default:
         warn("Read from unknown register offset: 0x%x\n", offset);
@@ -117,7 +321,7 @@ Tick IDMA::read(PacketPtr pkt) {
     pkt->makeResponse();
     
     // 5. 返回访问延迟（单位：Tick）
-    return 10;  // 你可以从参数中获取 pioDelay
+    return cyclesToTicks(pioLatency);
 }
 
 // CPU写IDMA寄存器
@@ -129,6 +333,13 @@ Tick IDMA::write(PacketPtr pkt) {
     Addr offset = addr - regBase;
     DPRINTF(IDMA, "Writing to IDMA regs, Address: %#x, Offset: %#x\n", addr, offset);
 
+    if (offset >= REG_CH_BASE &&
+        offset < REG_CH_BASE + channels.size() * REG_CH_STRIDE) {
+        Addr ch_offset = offset - REG_CH_BASE;
+        return writeChannelReg(ch_offset / REG_CH_STRIDE,
+                               ch_offset % REG_CH_STRIDE, pkt);
+    }
+
     // 3. 根据偏移地址写入相应的寄存器
     switch (offset) {
       case REG_STATUS_OFFSET:
@@ -179,14 +390,42 @@ Tick IDMA::write(PacketPtr pkt) {
         if (pkt->getSize() == sizeof(uint32_t)) {
             commandReg = pkt->getLE<uint32_t>();
             DPRINTF(IDMA, "Writing to COMMAND register, Value: %#x\n", commandReg);
-            // 根据命令寄存器启动 DMA 传输
+            // 根据命令寄存器启动 DMA 传输，使用写命令寄存器的核心的地址空间
             if (commandReg & 0x1) {
+                legacyCtx = pkt->req->hasContextId() ?
+                    pkt->req->contextId() : 0;
                 idmaTransfer();
             }
         } else {
             panic("Invalid access size for COMMAND register: %d\n", pkt->getSize());
         }
         break;
+
+      case REG_INT_STATUS_OFFSET:
+        // 写 1 清除对应的挂起位，CPU 在中断处理或 wfi 唤醒后应答
+        if (pkt->getSize() == sizeof(uint32_t)) {
+            intStatusReg &= ~pkt->getLE<uint32_t>();
+            DPRINTF(IDMA, "Acknowledging interrupts, INT_STATUS: %#x\n", intStatusReg);
+            updateIntPins();
+        } else {
+            panic("Invalid access size for INT_STATUS register: %d\n", pkt->getSize());
+        }
+        break;
+
+      case REG_INT_ENABLE_OFFSET:
+        if (pkt->getSize() == sizeof(uint32_t)) {
+            intEnableReg = pkt->getLE<uint32_t>();
+            DPRINTF(IDMA, "Writing to INT_ENABLE register, Value: %#x\n", intEnableReg);
+            updateIntPins();
+        } else {
+            panic("Invalid access size for INT_ENABLE register: %d\n", pkt->getSize());
+        }
+        break;
+
+      case REG_IOTLB_FLUSH_OFFSET:
+        // 软件修改或解除页表映射后写此寄存器
+        iotlbFlush();
+        break;
         
       default:
         warn("Write to unknown register offset: 0x%x\n", offset);
@@ -197,49 +436,435 @@ Tick IDMA::write(PacketPtr pkt) {
     pkt->makeResponse();
     
     // 5. 返回访问延迟
-    return 10;
+    return cyclesToTicks(pioLatency);
 }
 void IDMA::idmaTransfer() {
     uint32_t size = sizeReg;
     uint32_t srcAddr = srcAddrReg;
     uint32_t dstAddr = dstAddrReg;
     uint32_t command = commandReg;
-    uint32_t status = statusReg;
 
     // command = 1使能IDMA传输
     if (command & 0x1) {
-        // 读操作
-
-        if(dmaPending()) {
+        // 描述符通道也会占用 DMA 端口，因此这里只检查单次传输自身的状态
+        if (statusReg == IDMA_BUSY) {
             warn("DMA transfer already in progress!");
             return;
         }
         // 切换到busy状态
         statusReg = IDMA_BUSY;
 
-        // 为本次读传输创建回调对象，完成后调用 idmaReadDone
-        auto *readCb = new DmaVirtCallback<int>(
-            [this](const int &) { idmaReadDone(); });
-        dmaReadVirt(srcAddr, size, readCb, dmaBuffer);
-
+        // 整个传输完成（最后一个 burst 写完）后调用 idmaWriteDone
+        legacyStart = curTick();
+        transferBegin();
+        streamStart(legacyStream, legacyCtx, srcAddr, dstAddr, size,
+                    [this]() { idmaWriteDone(); });
     }
 }
-void IDMA::idmaReadDone() {
-    // 将数据从缓冲区写入目标地址
-    DPRINTF(IDMA, "idmaReadDone!calling dmaWrite(), Src: %#x, Dst: %#x, Size: %#x, Command: %#x, Status: %#x\n", srcAddrReg, dstAddrReg, sizeReg, commandReg, statusReg);
-
-    // 为写传输创建回调对象，完成后调用 idmaWriteDone
-    auto *writeCb = new DmaVirtCallback<int>(
-        [this](const int &) { idmaWriteDone(); });
-    dmaWriteVirt(dstAddrReg, sizeReg, writeCb, dmaBuffer);
-}
 
 void IDMA::idmaWriteDone() {
     // 传输完成！
     DPRINTF(IDMA, "idmaWriteDone! Src: %#x, Dst: %#x, Size: %#x, Command: %#x, Status: %#x\n", srcAddrReg, dstAddrReg, sizeReg, commandReg, statusReg);
     statusReg = IDMA_COMPLETE;
-    // 可以触发中断或通知 CPU
+    transferEnd(legacyStart);
+    raiseCompletion(INT_LEGACY);
+}
+
+void
+IDMA::streamStart(Stream &s, ContextID ctx, Addr src, Addr dst,
+                  uint32_t size, std::function<void()> done)
+{
+    s.ctx = ctx;
+    s.src = src;
+    s.dst = dst;
+    s.size = size;
+    s.readIssued = 0;
+    s.bytesWritten = 0;
+    s.readsInFlight = 0;
+    s.done = std::move(done);
+
+    if (size == 0) {
+        auto cb = std::move(s.done);
+        cb();
+        return;
+    }
+
+    // 非流水模式下只有一个与传输等长的槽位，即整块先读后写
+    unsigned slots = streaming ? stagingDepth : 1;
+    s.burst = streaming ? std::min(burstSize, size) : size;
+    s.staging.resize(s.burst * slots);
+    s.freeSlots.clear();
+    for (unsigned i = slots; i > 0; i--)
+        s.freeSlots.push_back(i - 1);
+
+    DPRINTF(IDMA, "Stream %#x -> %#x, %d bytes in %d-byte bursts\n",
+            src, dst, size, s.burst);
+    streamIssue(s);
 }
 
+void
+IDMA::streamIssue(Stream &s)
+{
+    // 受 staging 槽位和在途 burst 数的双重限制
+    while (s.readIssued < s.size && !s.freeSlots.empty() &&
+           s.readsInFlight < maxInflightBursts) {
+        unsigned slot = s.freeSlots.back();
+        s.freeSlots.pop_back();
+
+        uint32_t offset = s.readIssued;
+        uint32_t len = std::min(s.burst, s.size - offset);
+        s.readIssued += len;
+        s.readsInFlight++;
 
-}
\ No newline at end of file
+        auto *cb = new DmaVirtCallback<int>(
+            [this, &s, slot, offset, len](const int &) {
+                streamReadDone(s, slot, offset, len);
+            });
+        dmaXlate(BaseMMU::Read, s.ctx, s.src + offset, len, cb,
+                 &s.staging[slot * s.burst]);
+    }
+}
+
+void
+IDMA::streamReadDone(Stream &s, unsigned slot, uint32_t offset,
+                     uint32_t len)
+{
+    // 读回的 burst 立即转发给目的地址
+    s.readsInFlight--;
+    auto *cb = new DmaVirtCallback<int>(
+        [this, &s, slot, len](const int &) {
+            streamWriteDone(s, slot, len);
+        });
+    dmaXlate(BaseMMU::Write, s.ctx, s.dst + offset, len, cb,
+             &s.staging[slot * s.burst]);
+
+    streamIssue(s);
+}
+
+void
+IDMA::streamWriteDone(Stream &s, unsigned slot, uint32_t len)
+{
+    s.freeSlots.push_back(slot);
+    s.bytesWritten += len;
+    stats.bytes += len;
+
+    if (s.bytesWritten == s.size) {
+        auto cb = std::move(s.done);
+        cb();
+        return;
+    }
+    streamIssue(s);
+}
+
+Tick
+IDMA::readChannelReg(unsigned ch, Addr offset, PacketPtr pkt)
+{
+    panic_if(pkt->getSize() != sizeof(uint32_t),
+             "Invalid access size for channel %d register: %d\n",
+             ch, pkt->getSize());
+
+    Channel &chan = channels[ch];
+    switch (offset) {
+      case REG_CH_DESC_HEAD_OFFSET:
+        pkt->setLE<uint32_t>(chan.descHead);
+        break;
+      case REG_CH_STATUS_OFFSET:
+        pkt->setLE<uint32_t>(chan.status);
+        break;
+      case REG_CH_DESC_DONE_OFFSET:
+        pkt->setLE<uint32_t>(chan.descDone);
+        break;
+      case REG_CH_CUR_DESC_OFFSET:
+        pkt->setLE<uint32_t>(chan.curDesc);
+        break;
+      default:
+        warn("Read from unknown channel %d register offset: 0x%x\n",
+             ch, offset);
+        pkt->setLE<uint32_t>(0);
+        break;
+    }
+
+    pkt->makeResponse();
+    return cyclesToTicks(pioLatency);
+}
+
+Tick
+IDMA::writeChannelReg(unsigned ch, Addr offset, PacketPtr pkt)
+{
+    panic_if(pkt->getSize() != sizeof(uint32_t),
+             "Invalid access size for channel %d register: %d\n",
+             ch, pkt->getSize());
+
+    uint32_t value = pkt->getLE<uint32_t>();
+    switch (offset) {
+      case REG_CH_DESC_HEAD_OFFSET:
+        // 门铃寄存器：一次写入启动整条描述符链
+        chStart(ch, value,
+                pkt->req->hasContextId() ? pkt->req->contextId() : 0);
+        break;
+      case REG_CH_STATUS_OFFSET:
+        // 与 STATUS 寄存器一致，允许软件清除完成状态
+        if (channels[ch].status != IDMA_BUSY)
+            channels[ch].status = value;
+        break;
+      default:
+        warn("Write to unknown channel %d register offset: 0x%x\n",
+             ch, offset);
+        break;
+    }
+
+    pkt->makeResponse();
+    return cyclesToTicks(pioLatency);
+}
+
+void
+IDMA::chStart(unsigned ch, Addr head, ContextID ctx)
+{
+    Channel &chan = channels[ch];
+    if (chan.status == IDMA_BUSY) {
+        warn("IDMA channel %d is busy, ignoring new descriptor chain\n", ch);
+        return;
+    }
+    if (head == 0) {
+        warn("IDMA channel %d started with a null descriptor chain\n", ch);
+        return;
+    }
+
+    DPRINTF(IDMA, "Channel %d: starting descriptor chain at %#x\n",
+            ch, head);
+    chan.ctx = ctx;
+    chan.descHead = head;
+    chan.curDesc = head;
+    chan.descDone = 0;
+    chan.status = IDMA_BUSY;
+    chainStart[ch] = curTick();
+    transferBegin();
+    chFetchDesc(ch);
+}
+
+void
+IDMA::chFetchDesc(unsigned ch)
+{
+    Channel &chan = channels[ch];
+    auto *cb = new DmaVirtCallback<int>(
+        [this, ch](const int &) { chDescFetched(ch); });
+    dmaXlate(BaseMMU::Read, chan.ctx, chan.curDesc, DESC_SIZE, cb,
+             chan.descRaw);
+}
+
+void
+IDMA::chDescFetched(unsigned ch)
+{
+    Channel &chan = channels[ch];
+
+    // 描述符在内存中为小端格式
+    uint32_t words[DESC_WORDS];
+    std::memcpy(words, chan.descRaw, DESC_SIZE);
+    for (auto &w : words)
+        w = letoh(w);
+    Descriptor &d = chan.desc;
+    d.src = words[0];
+    d.dst = words[1];
+    d.length = words[2];
+    d.next = words[3];
+    d.srcStride = words[4];
+    d.dstStride = words[5];
+    d.numRows = words[6] ? words[6] : 1;
+    d.srcPlaneStride = words[7];
+    d.dstPlaneStride = words[8];
+    d.numPlanes = words[9] ? words[9] : 1;
+    d.flags = words[10];
+    d.reserved = words[11];
+
+    DPRINTF(IDMA, "Channel %d: descriptor %#x src %#x dst %#x len %d "
+            "rows %d planes %d next %#x\n", ch, chan.curDesc, d.src,
+            d.dst, d.length, d.numRows, d.numPlanes, d.next);
+
+    if (d.length == 0) {
+        warn("IDMA channel %d: descriptor %#x has zero length\n",
+             ch, chan.curDesc);
+        chFinish(ch, IDMA_ERROR);
+        return;
+    }
+
+    chan.row = 0;
+    chan.plane = 0;
+    chIssueRow(ch);
+}
+
+void
+IDMA::chIssueRow(unsigned ch)
+{
+    Channel &chan = channels[ch];
+    const Descriptor &d = chan.desc;
+    uint32_t src = d.src + chan.plane * d.srcPlaneStride +
+                   chan.row * d.srcStride;
+    uint32_t dst = d.dst + chan.plane * d.dstPlaneStride +
+                   chan.row * d.dstStride;
+
+    streamStart(chan.stream, chan.ctx, src, dst, d.length,
+                [this, ch]() { chRowWriteDone(ch); });
+}
+
+void
+IDMA::chRowWriteDone(unsigned ch)
+{
+    Channel &chan = channels[ch];
+    const Descriptor &d = chan.desc;
+
+    // 先走完一个面内的所有行，再进入下一个面
+    if (++chan.row < d.numRows) {
+        chIssueRow(ch);
+        return;
+    }
+    chan.row = 0;
+    if (++chan.plane < d.numPlanes) {
+        chIssueRow(ch);
+        return;
+    }
+
+    chan.descDone++;
+    stats.descriptors++;
+    if (d.next == 0 || (d.flags & DESC_FLAG_LAST)) {
+        chFinish(ch, IDMA_COMPLETE);
+        return;
+    }
+    chan.curDesc = d.next;
+    chFetchDesc(ch);
+}
+
+void
+IDMA::chFinish(unsigned ch, uint32_t status)
+{
+    Channel &chan = channels[ch];
+    DPRINTF(IDMA, "Channel %d: chain at %#x finished after %d descriptors, "
+            "status %d\n", ch, chan.descHead, chan.descDone, status);
+    chan.status = status;
+    transferEnd(chainStart[ch]);
+    raiseCompletion(intChannelBit(ch));
+}
+
+void
+IDMA::transferBegin()
+{
+    if (activeTransfers++ == 0) {
+        stats.idleCycles += ticksToCycles(curTick() - lastBusyChange);
+        lastBusyChange = curTick();
+    }
+}
+
+void
+IDMA::transferEnd(Tick start)
+{
+    stats.transfers++;
+    stats.transferLatency.sample(ticksToCycles(curTick() - start));
+
+    assert(activeTransfers > 0);
+    if (--activeTransfers == 0) {
+        stats.busyCycles += ticksToCycles(curTick() - lastBusyChange);
+        lastBusyChange = curTick();
+    }
+}
+
+void
+IDMA::flushBusyIdle()
+{
+    // 把尚未结束的忙/闲区间计入统计
+    Cycles open = ticksToCycles(curTick() - lastBusyChange);
+    if (activeTransfers > 0)
+        stats.busyCycles += open;
+    else
+        stats.idleCycles += open;
+    lastBusyChange = curTick();
+}
+
+void
+IDMA::preDumpStats()
+{
+    DmaVirtDevice::preDumpStats();
+    flushBusyIdle();
+}
+
+void
+IDMA::resetStats()
+{
+    DmaVirtDevice::resetStats();
+    lastBusyChange = curTick();
+}
+
+IDMA::IDMAStats::IDMAStats(IDMA &_idma)
+    : statistics::Group(&_idma), idma(_idma),
+      ADD_STAT(transfers, statistics::units::Count::get(),
+               "Number of completed transfers and descriptor chains"),
+      ADD_STAT(descriptors, statistics::units::Count::get(),
+               "Number of completed descriptors"),
+      ADD_STAT(bytes, statistics::units::Byte::get(),
+               "Number of bytes written to the destination"),
+      ADD_STAT(bandwidth, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Average bandwidth over the simulated time"),
+      ADD_STAT(busyBandwidth, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Bandwidth achieved while at least one transfer was active"),
+      ADD_STAT(transferLatency, statistics::units::Cycle::get(),
+               "Cycles from start to completion of a transfer"),
+      ADD_STAT(busyCycles, statistics::units::Cycle::get(),
+               "Cycles with at least one active transfer"),
+      ADD_STAT(idleCycles, statistics::units::Cycle::get(),
+               "Cycles with no active transfer"),
+      ADD_STAT(iotlbHits, statistics::units::Count::get(),
+               "Pages translated by an IOTLB hit"),
+      ADD_STAT(iotlbMisses, statistics::units::Count::get(),
+               "Pages that needed a page table walk"),
+      ADD_STAT(iotlbMissRate, statistics::units::Ratio::get(),
+               "Fraction of translated pages that missed in the IOTLB"),
+      ADD_STAT(translationCycles, statistics::units::Cycle::get(),
+               "Cycles DMA requests were delayed by address translation"),
+      ADD_STAT(iotlbFlushes, statistics::units::Count::get(),
+               "Number of writes to IOTLB_FLUSH")
+{
+}
+
+void
+IDMA::IDMAStats::regStats()
+{
+    statistics::Group::regStats();
+
+    bandwidth.precision(0);
+    bandwidth = bytes / simSeconds;
+
+    // 忙周期数乘以时钟周期换算成秒
+    busyBandwidth.precision(0);
+    busyBandwidth = bytes / (busyCycles *
+        statistics::constant((double)idma.clockPeriod() /
+                             sim_clock::Frequency));
+
+    transferLatency.init(16);
+
+    iotlbMissRate = iotlbMisses / (iotlbHits + iotlbMisses);
+}
+
+void
+IDMA::raiseCompletion(uint32_t bits)
+{
+    intStatusReg |= bits;
+    updateIntPins();
+}
+
+void
+IDMA::updateIntPins()
+{
+    bool level = (intStatusReg & intEnableReg) != 0;
+    for (auto &pin : intPins) {
+        if (pin->state() == level)
+            continue;
+        DPRINTF(IDMA, "%s completion interrupt, INT_STATUS: %#x\n",
+                level ? "Raising" : "Lowering", intStatusReg);
+        if (level)
+            pin->raise();
+        else
+            pin->lower();
+    }
+}
+
+}
@@ -2,17 +2,31 @@
 #define __IDMA_HH__
 #define IDMA_BUSY 1
 #define IDMA_COMPLETE 2
+#define IDMA_ERROR 3
 
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "arch/generic/mmu.hh"
+#include "base/statistics.hh"
 #include "dev/dma_virt_device.hh"
+#include "dev/intpin.hh"
+#include "mem/spm/spm_alias_mapper.hh"
+#include "mem/translation_gen.hh"
 #include "params/IDMA.hh"
 
 namespace gem5 {
 
+class BaseCPU;
+
 class IDMA : public DmaVirtDevice 
 {
   protected:
-    // 寄存器基地址（从配置中获取，或使用固定值）
-    Addr regBase;
+    // 寄存器窗口及访问延迟，来自 pio_addr / pio_size / pio_latency
+    const Addr regBase;
+    const Addr regSize;
+    const Cycles pioLatency;
     
     // DMA 控制寄存器
     uint32_t srcAddrReg;     // 源地址寄存器
@@ -20,9 +34,49 @@ class IDMA : public DmaVirtDevice
     uint32_t sizeReg;        // 传输长度寄存器
     uint32_t commandReg;     // 命令寄存器
     uint32_t statusReg;      // 状态寄存器
+    uint32_t intStatusReg;   // 中断挂起寄存器，写 1 清零
+    uint32_t intEnableReg;   // 中断使能寄存器
+
+    // 完成中断输出，INT_STATUS & INT_ENABLE 非零时为高电平
+    std::vector<std::unique_ptr<IntSourcePin<IDMA>>> intPins;
+
+    // 流水化传输参数
+    const bool streaming;          // false 时退化为整块先读后写
+    const uint32_t burstSize;      // 每个 burst 的字节数
+    const unsigned maxInflightBursts; // 同一传输最多同时在读的 burst 数
+    const unsigned stagingDepth;   // staging FIFO 的 burst 槽位数
+
+    /**
+     * 一次流水化拷贝。传输按 burst 切分，每个 burst 读完后立即写往目的地址，
+     * 写完释放其 staging 槽位，因此读和写可以重叠进行。
+     */
+    struct Stream
+    {
+        ContextID ctx = 0;         // 发起传输的核心，决定使用哪个地址空间
+        Addr src = 0;
+        Addr dst = 0;
+        uint32_t size = 0;
+        uint32_t burst = 0;
+        uint32_t readIssued = 0;   // 已发出读请求的字节数
+        uint32_t bytesWritten = 0; // 已写完的字节数
+        unsigned readsInFlight = 0;
 
-    // DMA 传输缓冲区
-    uint8_t *dmaBuffer;
+        std::vector<uint8_t> staging;
+        std::vector<unsigned> freeSlots;
+        std::function<void()> done;
+    };
+
+    // 单次传输寄存器使用的传输
+    Stream legacyStream;
+    // 最后一次写 COMMAND 寄存器的核心
+    ContextID legacyCtx = 0;
+
+    void streamStart(Stream &s, ContextID ctx, Addr src, Addr dst,
+                     uint32_t size, std::function<void()> done);
+    void streamIssue(Stream &s);
+    void streamReadDone(Stream &s, unsigned slot, uint32_t offset,
+                        uint32_t len);
+    void streamWriteDone(Stream &s, unsigned slot, uint32_t len);
 
     // 寄存器偏移地址（相对于基地址）
     static const Addr REG_SRC_ADDR_OFFSET = 0x00;
@@ -30,19 +84,206 @@ class IDMA : public DmaVirtDevice
     static const Addr REG_SIZE_OFFSET = 0x08;
     static const Addr REG_COMMAND_OFFSET = 0x0C;
     static const Addr REG_STATUS_OFFSET = 0x10;
+    static const Addr REG_INT_STATUS_OFFSET = 0x14;
+    static const Addr REG_INT_ENABLE_OFFSET = 0x18;
+    static const Addr REG_IOTLB_FLUSH_OFFSET = 0x1C; // 写任意值作废 IOTLB
+
+    // 中断位：bit 0 为单次传输，bit (1 + ch) 为通道 ch
+    static const uint32_t INT_LEGACY = 0x1;
+    static uint32_t intChannelBit(unsigned ch) { return 0x2u << ch; }
+
+    // 通道寄存器窗口：从 0x100 开始，每个通道占 0x20 字节
+    static const Addr REG_CH_BASE = 0x100;
+    static const Addr REG_CH_STRIDE = 0x20;
+    static const Addr REG_CH_DESC_HEAD_OFFSET = 0x00; // 写入即启动描述符链
+    static const Addr REG_CH_STATUS_OFFSET = 0x04;
+    static const Addr REG_CH_DESC_DONE_OFFSET = 0x08; // 已完成的描述符个数
+    static const Addr REG_CH_CUR_DESC_OFFSET = 0x0C;  // 正在处理的描述符地址
+
+    /**
+     * 内存中的描述符，全部为小端 32 位字段，共 48 字节。
+     * 一个描述符描述一个最多三维的块拷贝：
+     * 每行 length 字节，numRows 行组成一个面，numPlanes 个面。
+     * 行数/面数为 0 时按 1 处理，next 为 0 或 flags 带 LAST 时链结束。
+     */
+    struct Descriptor
+    {
+        uint32_t src;
+        uint32_t dst;
+        uint32_t length;
+        uint32_t next;
+        uint32_t srcStride;
+        uint32_t dstStride;
+        uint32_t numRows;
+        uint32_t srcPlaneStride;
+        uint32_t dstPlaneStride;
+        uint32_t numPlanes;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+    static const unsigned DESC_WORDS = 12;
+    static const unsigned DESC_SIZE = DESC_WORDS * sizeof(uint32_t);
+    static const uint32_t DESC_FLAG_LAST = 0x1;
+
+    // 描述符通道的运行状态
+    struct Channel
+    {
+        ContextID ctx = 0;   // 启动描述符链的核心
+        Addr descHead = 0;
+        Addr curDesc = 0;
+        uint32_t status = 0;
+        uint32_t descDone = 0;
+
+        Descriptor desc = {};
+        uint32_t row = 0;
+        uint32_t plane = 0;
+
+        // 描述符读回的原始字节和当前行的传输
+        uint8_t descRaw[DESC_SIZE] = {};
+        Stream stream;
+    };
+    std::vector<Channel> channels;
+
+    // 单次传输的启动时间，用于统计传输延迟
+    Tick legacyStart = 0;
+    // 描述符链的启动时间
+    std::vector<Tick> chainStart;
+
+    // 忙/闲周期统计：正在进行的传输个数及上次切换忙闲状态的时刻
+    unsigned activeTransfers = 0;
+    Tick lastBusyChange = 0;
+
+    void transferBegin();
+    void transferEnd(Tick start);
+    void flushBusyIdle();
+
+    /**
+     * IOTLB：全相联、LRU 替换，按 4KB 页缓存 (上下文, 虚页号) -> 物理页号。
+     * 缺失时通过发起核心的 MMU 做功能性页表遍历（FS 模式下即 RISC-V 的
+     * Walker，SE 模式下为进程页表），遍历耗时由 iotlb_walk_latency 建模。
+     */
+    struct IotlbEntry
+    {
+        bool valid = false;
+        ContextID ctx = InvalidContextID;
+        Addr vpn = 0;
+        Addr ppn = 0;
+        uint64_t lastUse = 0;
+        // 页表遍历完成的时刻，之前命中该项的访问要等到此时
+        Tick ready = 0;
+    };
+    static const unsigned IOTLB_PAGE_SHIFT = 12;
+    static const Addr IOTLB_PAGE_SIZE = Addr(1) << IOTLB_PAGE_SHIFT;
+
+    std::vector<IotlbEntry> iotlb;
+    uint64_t iotlbUseCount = 0;
+    const Cycles iotlbHitLatency;
+    const Cycles iotlbWalkLatency;
+
+    /**
+     * alias_decode 时页表把别名原样映射，IDMA 翻译得到的仍是别名地址。
+     * aliasCpus[i] 发起的传输用 aliasMappers[i]（该核心自己的译码器）
+     * 把别名换成真名，共享 IDMA 也能按发起核心区分核别名。
+     */
+    std::vector<SpmAliasMapper *> aliasMappers;
+    std::vector<BaseCPU *> aliasCpus;
+    Addr decodeAlias(ContextID ctx, Addr paddr) const;
+
+    // 当前 DMA 请求的上下文和访问类型，供 translate() 使用
+    ContextID xlateCtx = 0;
+    BaseMMU::Mode xlateMode = BaseMMU::Read;
+
+    /** 按 IOTLB 内容逐页翻译，未缓存的页直接遍历页表 */
+    class IotlbTranslationGen : public TranslationGen
+    {
+      private:
+        IDMA &idma;
+        ContextID ctx;
+        BaseMMU::Mode mode;
+
+        void translate(Range &range) const override;
+
+      public:
+        IotlbTranslationGen(IDMA &_idma, ContextID _ctx,
+                            BaseMMU::Mode _mode, Addr vaddr, Addr size)
+            : TranslationGen(vaddr, size), idma(_idma), ctx(_ctx),
+              mode(_mode)
+        {}
+    };
+
+    IotlbEntry *iotlbProbe(ContextID ctx, Addr vpn);
+    Fault iotlbWalk(ContextID ctx, Addr vaddr, BaseMMU::Mode mode,
+                    Addr &paddr);
+    Tick iotlbAccess(ContextID ctx, Addr vaddr, Addr size,
+                     BaseMMU::Mode mode);
+    void iotlbFlush();
+
+    // 先查 IOTLB 得到翻译延迟，再把 DMA 请求推迟这么久发出
+    void dmaXlate(BaseMMU::Mode mode, ContextID ctx, Addr vaddr,
+                  unsigned size, DmaCallback *cb, void *data);
+
+    struct IDMAStats : public statistics::Group
+    {
+        IDMAStats(IDMA &idma);
+        void regStats() override;
+
+        IDMA &idma;
+
+        /** 完成的单次传输和描述符链个数 */
+        statistics::Scalar transfers;
+        /** 完成的描述符个数 */
+        statistics::Scalar descriptors;
+        /** 写到目的地址的字节数 */
+        statistics::Scalar bytes;
+        /** 整个仿真时间内的平均带宽 */
+        statistics::Formula bandwidth;
+        /** 只计忙周期的带宽，即 DMA 工作时实际达到的带宽 */
+        statistics::Formula busyBandwidth;
+        /** 从启动到完成的传输延迟（周期） */
+        statistics::Histogram transferLatency;
+        /** 至少有一个传输在进行的周期数 */
+        statistics::Scalar busyCycles;
+        statistics::Scalar idleCycles;
+        /** IOTLB 命中和缺失的页数 */
+        statistics::Scalar iotlbHits;
+        statistics::Scalar iotlbMisses;
+        statistics::Formula iotlbMissRate;
+        /** 因地址翻译推迟 DMA 请求的总周期数 */
+        statistics::Scalar translationCycles;
+        statistics::Scalar iotlbFlushes;
+    } stats;
+
+    Tick readChannelReg(unsigned ch, Addr offset, PacketPtr pkt);
+    Tick writeChannelReg(unsigned ch, Addr offset, PacketPtr pkt);
 
   public:
     PARAMS(IDMA);
     IDMA(const Params &p);
-    ~IDMA();
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
 
     AddrRangeList getAddrRanges() const override;
     Tick read(PacketPtr pkt) override;
     Tick write(PacketPtr pkt) override;
     TranslationGenPtr translate(Addr vaddr, Addr size) override;
+
+    void preDumpStats() override;
+    void resetStats() override;
     void idmaTransfer();
-    void idmaReadDone();
     void idmaWriteDone();
+
+    // 描述符通道的状态机：取描述符 -> 逐行传输 -> 下一个描述符
+    void chStart(unsigned ch, Addr head, ContextID ctx);
+    void chFetchDesc(unsigned ch);
+    void chDescFetched(unsigned ch);
+    void chIssueRow(unsigned ch);
+    void chRowWriteDone(unsigned ch);
+    void chFinish(unsigned ch, uint32_t status);
+
+    // 置位中断挂起位并刷新中断引脚电平
+    void raiseCompletion(uint32_t bits);
+    void updateIntPins();
 };
 
 };
@@ -33,7 +33,9 @@
  #include "mem/spm/spm.hh"
  #include "debug/Drain.hh"
  #include "debug/ScratchpadMemory.hh"
+ #include "sim/stats.hh"
 #include "spm.hh"
+#include <algorithm>
 #include <iostream>
  
 namespace gem5 {
@@ -44,6 +46,7 @@ namespace memory {
     ScratchpadMemory::DmaPort::DmaPort(const std::string& _name, ScratchpadMemory& _memory)
         : ResponsePort(_name), owner(_memory),
         retryResp(false),
+        retryReq(false),
         dmaDequeueEvent([this]{ dmaDequeue(); }, name() + ".dmaDequeue")
     { 
         std::cout<<_name << " DmaPort constructor" << std::endl;
@@ -52,8 +55,78 @@ namespace memory {
     // 构造函数
     ScratchpadMemory::ScratchpadMemory(const Params &p) 
         : SimpleMemory(p),
-          dmaPort(name() + ".dma_port", *this)
+          dmaPort(name() + ".dma_port", *this),
+          numBanks(p.num_banks),
+          bankWidth(p.bank_width),
+          bankLatency(p.bank_latency),
+          dmaPriority(p.dma_priority),
+          dmaRespQueueDepth(p.dma_resp_queue_depth),
+          dmaRespReorder(p.dma_resp_reorder),
+          highBusyUntil(p.num_banks, 0),
+          lowBusyUntil(p.num_banks, 0),
+          spmStats(*this)
     {
+        fatal_if(numBanks == 0 || bankWidth == 0,
+                 "%s: num_banks and bank_width must be non-zero\n", name());
+        fatal_if(dmaRespQueueDepth == 0,
+                 "%s: dma_resp_queue_depth must be non-zero\n", name());
+    }
+
+    ScratchpadMemory::SpmStats::SpmStats(ScratchpadMemory &_spm)
+        : statistics::Group(&_spm), spm(_spm),
+          ADD_STAT(bankConflicts, statistics::units::Count::get(),
+                   "Number of accesses delayed by a bank conflict"),
+          ADD_STAT(bankConflictCycles, statistics::units::Cycle::get(),
+                   "Cycles accesses spent waiting for a busy bank"),
+          ADD_STAT(bankAccesses, statistics::units::Count::get(),
+                   "Number of word accesses per bank"),
+          ADD_STAT(portBytesRead, statistics::units::Byte::get(),
+                   "Number of bytes read through each port"),
+          ADD_STAT(portBytesWritten, statistics::units::Byte::get(),
+                   "Number of bytes written through each port"),
+          ADD_STAT(portBandwidth, statistics::units::Rate<
+                        statistics::units::Byte, statistics::units::Second>::get(),
+                   "Read plus write bandwidth of each port"),
+          ADD_STAT(dmaQueueDelay, statistics::units::Cycle::get(),
+                   "Cycles DMA responses waited past their ready time"),
+          ADD_STAT(dmaQueuePeak, statistics::units::Count::get(),
+                   "Peak number of queued DMA responses"),
+          ADD_STAT(dmaQueueOccupancy, statistics::units::Count::get(),
+                   "Average number of queued DMA responses"),
+          ADD_STAT(dmaQueueFullRejects, statistics::units::Count::get(),
+                   "Number of DMA requests refused by a full response queue")
+    {
+    }
+
+    void
+    ScratchpadMemory::SpmStats::regStats()
+    {
+        statistics::Group::regStats();
+
+        bankConflicts.init(NUM_REQUESTOR_CLASSES);
+        bankConflicts.subname(CPU, "cpu");
+        bankConflicts.subname(DMA, "dma");
+
+        bankConflictCycles.init(NUM_REQUESTOR_CLASSES);
+        bankConflictCycles.subname(CPU, "cpu");
+        bankConflictCycles.subname(DMA, "dma");
+
+        bankAccesses.init(spm.numBanks);
+
+        portBytesRead.init(NUM_REQUESTOR_CLASSES);
+        portBytesRead.subname(CPU, "cpu");
+        portBytesRead.subname(DMA, "dma");
+
+        portBytesWritten.init(NUM_REQUESTOR_CLASSES);
+        portBytesWritten.subname(CPU, "cpu");
+        portBytesWritten.subname(DMA, "dma");
+
+        portBandwidth.precision(0);
+        portBandwidth = (portBytesRead + portBytesWritten) / simSeconds;
+        portBandwidth.subname(CPU, "cpu");
+        portBandwidth.subname(DMA, "dma");
+
+        dmaQueueDelay.init(16);
     }
 
     void
@@ -78,11 +151,105 @@ namespace memory {
     }
 
     void
-    ScratchpadMemory::regStats()
+    ScratchpadMemory::countAccess(PacketPtr pkt, RequestorClass cls)
+    {
+        if (pkt->isRead())
+            spmStats.portBytesRead[cls] += pkt->getSize();
+        else if (pkt->isWrite())
+            spmStats.portBytesWritten[cls] += pkt->getSize();
+    }
+
+    void
+    ScratchpadMemory::dmaQueueChanged(size_t depth)
+    {
+        spmStats.dmaQueueOccupancy = depth;
+        if (depth > spmStats.dmaQueuePeak.value())
+            spmStats.dmaQueuePeak = depth;
+    }
+
+    // 一次访问覆盖 [addr, addr + size) 内的所有字，相邻字交织在不同 bank 上。
+    // 访问要等它涉及的所有 bank 空闲后才能开始，每个 bank 按分到的字数占用。
+    Tick
+    ScratchpadMemory::bankArbitrate(PacketPtr pkt, RequestorClass cls)
+    {
+        const Tick now = curTick();
+        const Tick word_time = cyclesToTicks(bankLatency);
+        const Addr first_word = pkt->getAddr() / bankWidth;
+        const Addr last_word = (pkt->getAddr() + pkt->getSize() - 1) /
+            bankWidth;
+        const Addr words = last_word - first_word + 1;
+        const unsigned touched = std::min<Addr>(words, numBanks);
+        const bool high = (cls == DMA) == dmaPriority;
+
+        Tick start = now;
+        for (unsigned i = 0; i < touched; i++) {
+            unsigned bank = (first_word + i) % numBanks;
+            Tick ready;
+            if (high) {
+                // 低优先级访问只会让高优先级访问等到它当前这个字完成
+                ready = highBusyUntil[bank];
+                if (lowBusyUntil[bank] > std::max(now, ready)) {
+                    ready = std::max(ready,
+                        std::min(lowBusyUntil[bank], now + word_time));
+                }
+            } else {
+                ready = std::max(highBusyUntil[bank], lowBusyUntil[bank]);
+            }
+            start = std::max(start, ready);
+        }
+
+        for (unsigned i = 0; i < touched; i++) {
+            unsigned bank = (first_word + i) % numBanks;
+            Addr bank_words = (words - i + numBanks - 1) / numBanks;
+            Tick occupancy = bank_words * word_time;
+            spmStats.bankAccesses[bank] += bank_words;
+            if (high) {
+                highBusyUntil[bank] = start + occupancy;
+                // 抢占只顺延之后到达的低优先级访问：已接受的低优先级访问
+                // 的响应时间在 bankArbitrate 返回时已经确定，不再改动，
+                // 所以只把低优先级的预约边界整体后移
+                if (lowBusyUntil[bank] > start)
+                    lowBusyUntil[bank] += occupancy;
+            } else {
+                lowBusyUntil[bank] = start + occupancy;
+            }
+        }
+
+        Tick stall = start - now;
+        if (stall > 0) {
+            spmStats.bankConflicts[cls]++;
+            spmStats.bankConflictCycles[cls] += ticksToCycles(stall);
+            DPRINTF(ScratchpadMemory, "%s access to %#x stalled %d ticks on "
+                    "a bank conflict\n", cls == DMA ? "DMA" : "CPU",
+                    pkt->getAddr(), stall);
+        }
+
+        // 每个 bank 第一个字的时间已计入 latency 参数，
+        // 超过一轮的字需要额外串行访问
+        Addr rounds = (words + numBanks - 1) / numBanks;
+        return stall + (rounds - 1) * word_time;
+    }
+
+    Tick
+    ScratchpadMemory::accessDelay(PacketPtr pkt)
+    {
+        countAccess(pkt, CPU);
+        return bankArbitrate(pkt, CPU);
+    }
+
+    // CPU 端口的原子访问不经过 bank 仲裁，只统计字节数；
+    // 不提供 backdoor，否则原子 CPU 之后的访问绕过端口，统计不到
+    void
+    ScratchpadMemory::atomicAccess(PacketPtr pkt)
     {
-        // using namespace Stats;
+        countAccess(pkt, CPU);
+    }
 
-        SimpleMemory::regStats();
+    Tick
+    ScratchpadMemory::dmaAccessDelay(PacketPtr pkt)
+    {
+        countAccess(pkt, DMA);
+        return bankArbitrate(pkt, DMA);
     }
 
     // Public method for DmaPort to process requests
@@ -96,10 +263,15 @@ namespace memory {
     }
 
     // Public method for DmaPort to schedule events
+    // 已调度的事件只会被提前，不会被推迟；已经就绪的队首在当前 tick 处理
     void
     ScratchpadMemory::scheduleDmaEvent(Event &event, Tick when)
     {
-        schedule(event, when);
+        when = std::max(when, curTick());
+        if (!event.scheduled())
+            schedule(event, when);
+        else if (when < event.when())
+            reschedule(event, when);
     }
     
 
@@ -114,11 +286,20 @@ namespace memory {
         // Get the first packet from the queue
         auto [pkt, ready_time] = dmaPacketQueue.front();
 
+        // 重排序模式下队首可能换成了更晚才就绪的响应
+        if (ready_time > curTick()) {
+            owner.scheduleDmaEvent(dmaDequeueEvent, ready_time);
+            return;
+        }
+
         // Try to send the response
         if (sendTimingResp(pkt)) {
             // Success - remove from queue
             dmaPacketQueue.pop_front();
             retryResp = false;
+            owner.spmStats.dmaQueueDelay.sample(
+                owner.ticksToCycles(curTick() - ready_time));
+            owner.dmaQueueChanged(dmaPacketQueue.size());
 
             // If there are more packets, schedule next dequeue
             if (!dmaPacketQueue.empty()) {
@@ -129,6 +310,15 @@ namespace memory {
                     owner.scheduleDmaEvent(dmaDequeueEvent, schedule_time);
                 }
             }
+
+            // 释放了一个队列项，通知之前被拒绝的请求方重试。重试可能同步
+            // 调用 recvTimingReq，所以要在下一次出队调度好之后再发
+            if (retryReq) {
+                retryReq = false;
+                DPRINTF(ScratchpadMemory, "Response queue has space, "
+                        "sending retry request\n");
+                sendRetryReq();
+            }
         } else {
             // Failed - wait for retry
             retryResp = true;
@@ -150,6 +340,7 @@ namespace memory {
     Tick
     ScratchpadMemory::DmaPort::recvAtomic(PacketPtr pkt)
     {
+        owner.countAccess(pkt, DMA);
         return owner.recvAtomic(pkt); // 转发给 owner 处理
     }
 
@@ -173,20 +364,47 @@ namespace memory {
         // Process the packet similar to SimpleMemory
         bool needs_response = pkt->needsResponse();
 
+        // 响应队列已满时拒绝请求，等有空位时再发 retry，
+        // 以此限制同时在途的 DMA 事务数
+        if (needs_response &&
+            dmaPacketQueue.size() >= owner.dmaRespQueueDepth) {
+            DPRINTF(ScratchpadMemory, "Response queue full (%d), "
+                    "refusing request to %#x\n", dmaPacketQueue.size(),
+                    pkt->getAddr());
+            owner.spmStats.dmaQueueFullRejects++;
+            retryReq = true;
+            return false;
+        }
+
+        // DMA 访问与 CPU 访问共享同一组 SRAM bank
+        Tick bank_delay = owner.dmaAccessDelay(pkt);
+
         // Use owner's public method to process the packet
         // This will access memory and create response
-        Tick latency = owner.processDmaRequest(pkt);
+        Tick latency = bank_delay + owner.processDmaRequest(pkt);
 
         if (needs_response) {
             // Calculate when to send response
             Tick when_to_send = curTick() + latency;
 
-            // Add to response queue
-            dmaPacketQueue.push_back(std::make_pair(pkt, when_to_send));
+            // Add to response queue. With dma_resp_reorder the queue is
+            // kept sorted by ready time, so a slow response does not hold
+            // back the ones that are ready before it.
+            auto pos = dmaPacketQueue.end();
+            if (owner.dmaRespReorder) {
+                pos = std::upper_bound(dmaPacketQueue.begin(),
+                    dmaPacketQueue.end(), when_to_send,
+                    [](Tick when, const std::pair<PacketPtr, Tick> &e) {
+                        return when < e.second;
+                    });
+            }
+            dmaPacketQueue.insert(pos, std::make_pair(pkt, when_to_send));
+            owner.dmaQueueChanged(dmaPacketQueue.size());
 
-            // Schedule dequeue event if not already scheduled
-            if (!retryResp && !dmaDequeueEvent.scheduled()) {
-                owner.scheduleDmaEvent(dmaDequeueEvent, when_to_send);
+            // Schedule dequeue event for the head of the queue
+            if (!retryResp) {
+                owner.scheduleDmaEvent(dmaDequeueEvent,
+                                       dmaPacketQueue.front().second);
             }
         }
 
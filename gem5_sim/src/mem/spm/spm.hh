@@ -46,6 +46,7 @@
  #define __SCRATCHPAD_MEMORY_HH__
  
  #include <deque>
+ #include <vector>
  
  #include "base/statistics.hh"
  #include "mem/simple_mem.hh"
@@ -72,11 +73,15 @@ namespace memory
        private:
          ScratchpadMemory &owner;
          
-         // Queue for outgoing responses
+         // Queue for outgoing responses, bounded by dma_resp_queue_depth
          std::deque<std::pair<PacketPtr, Tick>> dmaPacketQueue;
          
          // Whether we are waiting for a retry from the peer
          bool retryResp;
+
+         // Whether we refused a request because the response queue was
+         // full and owe the peer a retry
+         bool retryReq;
          
          // Event to dequeue packets
          EventFunctionWrapper dmaDequeueEvent;
@@ -95,9 +100,95 @@ namespace memory
  
      DmaPort dmaPort;
 
+     /** Which port an access arrived on, for bank arbitration */
+     enum RequestorClass
+     {
+         CPU = 0,
+         DMA,
+         NUM_REQUESTOR_CLASSES
+     };
+
+     /** Number of interleaved single-ported SRAM banks */
+     const unsigned numBanks;
+
+     /** Bytes per bank word, i.e. the interleaving granularity */
+     const unsigned bankWidth;
+
+     /** Cycles a bank stays busy per word access */
+     const Cycles bankLatency;
+
+     /** Whether DMA wins bank conflicts against the CPU */
+     const bool dmaPriority;
+
+     /** Responses the DMA port may hold before it refuses requests */
+     const unsigned dmaRespQueueDepth;
+
+     /** Send DMA responses in ready-time order instead of arrival order */
+     const bool dmaRespReorder;
+
+     /**
+      * Per-bank reservation horizon of the high and low priority
+      * requestor classes. A high priority access only waits for the word
+      * a low priority access is currently working on, and pushes the rest
+      * of that reservation back by its own occupancy. Only low priority
+      * accesses that arrive later see the pushed-back horizon: the
+      * response time of an access already accepted is not changed.
+      */
+     std::vector<Tick> highBusyUntil;
+     std::vector<Tick> lowBusyUntil;
+
+     struct SpmStats : public statistics::Group
+     {
+         SpmStats(ScratchpadMemory &spm);
+
+         void regStats() override;
+
+         const ScratchpadMemory &spm;
+
+         /** Accesses delayed by a bank conflict, per requestor class */
+         statistics::Vector bankConflicts;
+         /** Cycles lost to bank conflicts, per requestor class */
+         statistics::Vector bankConflictCycles;
+         /** Word accesses per bank */
+         statistics::Vector bankAccesses;
+
+         /** Bytes read and written through each port */
+         statistics::Vector portBytesRead;
+         statistics::Vector portBytesWritten;
+         statistics::Formula portBandwidth;
+
+         /** Cycles a DMA response waited in dmaPacketQueue past its
+          * ready time */
+         statistics::Histogram dmaQueueDelay;
+         /** Largest number of responses held in dmaPacketQueue */
+         statistics::Scalar dmaQueuePeak;
+         /** Time-weighted average number of queued DMA responses */
+         statistics::Average dmaQueueOccupancy;
+         /** DMA requests refused because the response queue was full */
+         statistics::Scalar dmaQueueFullRejects;
+     } spmStats;
+
+     /** Account the bytes of an access against the port it came from */
+     void countAccess(PacketPtr pkt, RequestorClass cls);
+
+     /** Record a change of the DMA response queue depth */
+     void dmaQueueChanged(size_t depth);
+
+     /**
+      * Arbitrate for the banks a timing access touches and reserve them.
+      *
+      * @param pkt the request
+      * @param cls the port the request arrived on
+      * @return the extra delay before the access completes
+      */
+     Tick bankArbitrate(PacketPtr pkt, RequestorClass cls);
+
+     Tick accessDelay(PacketPtr pkt) override;
+     void atomicAccess(PacketPtr pkt) override;
+     bool backdoorAllowed() const override { return false; }
+
    public:
      PARAMS(ScratchpadMemory);
-     void regStats();
      ScratchpadMemory(const Params &p);
      void init() override;
 
@@ -105,6 +196,7 @@ namespace memory
                    PortID idx=InvalidPortID) override;
 
      // Public methods for DmaPort to access
+     Tick dmaAccessDelay(PacketPtr pkt);
      Tick processDmaRequest(PacketPtr pkt);
      void scheduleDmaEvent(Event &event, Tick when);
  };
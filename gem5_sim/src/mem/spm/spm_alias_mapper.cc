@@ -0,0 +1,96 @@
+#include "mem/spm/spm_alias_mapper.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+SpmAliasMapper::SpmAliasMapper(const Params &p)
+    : AddrMapper(p),
+      clusterBase(p.cluster_base),
+      clusterShift(floorLog2(p.cluster_stride)),
+      l2Offset(p.l2_offset),
+      globalShift(floorLog2(p.global_stride)),
+      globalMask(p.global_stride - 1)
+{
+    fatal_if(!isPowerOf2(p.cluster_stride) || !isPowerOf2(p.global_stride),
+             "%s: cluster_stride and global_stride must be powers of two\n",
+             name());
+    fatal_if(p.core_id * p.core_stride + p.self_alias.size() >
+             p.cluster_stride,
+             "%s: core %d lies outside the cluster window\n",
+             name(), p.core_id);
+
+    Addr cluster_real = clusterBase +
+                        (Addr(p.cluster_id) << clusterShift);
+    aliases[SELF] = { p.self_alias.start(), p.self_alias.size(),
+                      cluster_real + p.core_id * p.core_stride };
+    aliases[L2] = { p.l2_alias.start(), p.l2_alias.size(),
+                    cluster_real + l2Offset };
+    aliases[CLUSTER] = { p.cluster_alias.start(), p.cluster_alias.size(),
+                         cluster_real };
+    aliases[GLOBAL] = { p.global_alias.start(), p.global_alias.size(), 0 };
+
+    fatal_if(aliases[CLUSTER].size > p.cluster_stride,
+             "%s: cluster_alias is larger than a cluster window\n", name());
+    fatal_if(aliases[GLOBAL].size > p.num_clusters * p.global_stride,
+             "%s: global_alias covers more than %d clusters\n", name(),
+             p.num_clusters);
+
+    // 别名窗口之间不能重叠，否则同一地址有两种译码结果
+    for (int i = 0; i < NUM_ALIAS_KINDS; i++) {
+        for (int j = i + 1; j < NUM_ALIAS_KINDS; j++) {
+            const Alias &a = aliases[i];
+            const Alias &b = aliases[j];
+            fatal_if(a.size && b.size && a.start < b.start + b.size &&
+                     b.start < a.start + a.size,
+                     "%s: alias windows %d and %d overlap\n", name(), i, j);
+        }
+    }
+}
+
+Addr
+SpmAliasMapper::remapAddr(Addr addr) const
+{
+    for (int kind = 0; kind < NUM_ALIAS_KINDS; kind++) {
+        const Alias &alias = aliases[kind];
+        // 无符号减法：addr 低于 start 时得到很大的偏移，一次比较即可
+        Addr offset = addr - alias.start;
+        if (offset >= alias.size)
+            continue;
+
+        if (kind != GLOBAL)
+            return alias.target + offset;
+
+        // 簇真名：高位选簇，低位是簇内 L2 的偏移
+        Addr cluster = offset >> globalShift;
+        return clusterBase + (cluster << clusterShift) + l2Offset +
+               (offset & globalMask);
+    }
+    return addr;
+}
+
+MemBackdoorPtr
+SpmAliasMapper::getRevertedBackdoor(MemBackdoorPtr &backdoor,
+                                    const AddrRange &range)
+{
+    // 真名访问不经过重映射，可以直接使用目标的 backdoor；
+    // 别名访问不提供 backdoor，退回到普通的包访问
+    if (remapAddr(range.start()) == range.start())
+        return backdoor;
+    return nullptr;
+}
+
+AddrRangeList
+SpmAliasMapper::getAddrRanges() const
+{
+    AddrRangeList ranges = memSidePort.getAddrRanges();
+    for (const auto &alias : aliases) {
+        if (alias.size)
+            ranges.push_back(RangeSize(alias.start, alias.size));
+    }
+    return ranges;
+}
+
+} // namespace gem5
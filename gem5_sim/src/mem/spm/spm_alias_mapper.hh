@@ -0,0 +1,83 @@
+#ifndef __MEM_SPM_SPM_ALIAS_MAPPER_HH__
+#define __MEM_SPM_SPM_ALIAS_MAPPER_HH__
+
+#include <array>
+
+#include "mem/addr_mapper.hh"
+#include "params/SpmAliasMapper.hh"
+
+namespace gem5
+{
+
+/**
+ * Alias decoder of docs/mem_hier_v0.md 1.3, placed between a core and its
+ * cluster crossbar.
+ *
+ * Besides the real names (the 40-bit physical windows of every cluster),
+ * a core may use four 32-bit alias windows:
+ *  - self alias (核别名): its own L1I/L1D SPMs,
+ *  - L2 alias (簇别名): the L2 SPM of its own cluster,
+ *  - cluster alias (簇中核真名): the whole window of its own cluster,
+ *  - global alias (簇真名): the L2 SPM of every cluster, global_stride
+ *    apart.
+ * Addresses outside the windows pass through unchanged. Every window is
+ * decoded with one subtraction and compare and remapped with shifts and
+ * masks, so the cost does not depend on the number of cores or clusters.
+ */
+class SpmAliasMapper : public AddrMapper
+{
+  public:
+    PARAMS(SpmAliasMapper);
+    SpmAliasMapper(const Params &p);
+
+    AddrRangeList getAddrRanges() const override;
+
+    /** Real address of an alias, for requestors behind another port */
+    Addr decode(Addr addr) const { return remapAddr(addr); }
+
+    void
+    init() override
+    {
+        AddrMapper::init();
+        cpuSidePort.sendRangeChange();
+    }
+
+  protected:
+    enum AliasKind
+    {
+        SELF = 0,
+        L2,
+        CLUSTER,
+        GLOBAL,
+        NUM_ALIAS_KINDS
+    };
+
+    /** One alias window: [start, start + size) in the requestor's view */
+    struct Alias
+    {
+        Addr start;
+        Addr size;
+        /** Real address of offset 0, unused for GLOBAL */
+        Addr target;
+    };
+    std::array<Alias, NUM_ALIAS_KINDS> aliases;
+
+    /** Real address of cluster 0 */
+    const Addr clusterBase;
+    /** log2 of the real window of one cluster */
+    const unsigned clusterShift;
+    /** Offset of the L2 SPM inside a cluster window */
+    const Addr l2Offset;
+    /** log2 and mask of the global alias stride */
+    const unsigned globalShift;
+    const Addr globalMask;
+
+    Addr remapAddr(Addr addr) const override;
+
+    MemBackdoorPtr getRevertedBackdoor(MemBackdoorPtr &backdoor,
+                                       const AddrRange &range) override;
+};
+
+} // namespace gem5
+
+#endif // __MEM_SPM_SPM_ALIAS_MAPPER_HH__
@@ -27,20 +27,113 @@
 
 #include "mem/thread_bridge.hh"
 
+#include <algorithm>
+
+#include "base/logging.hh"
 #include "base/trace.hh"
+#include "debug/ThreadBridge.hh"
 #include "sim/eventq.hh"
 
 namespace gem5
 {
 
 ThreadBridge::ThreadBridge(const ThreadBridgeParams &p)
-    : SimObject(p), in_port_("in_port", *this), out_port_("out_port", *this)
+    : SimObject(p),
+      in_port_("in_port", *this, p.req_size, p.resp_size),
+      out_port_("out_port", *this, p.req_size),
+      inQueue_(getEventQueue(p.in_eventq_index)),
+      outQueue_(eventQueue()),
+      crossQueue_(inQueue_ != outQueue_),
+      delay_(p.delay),
+      reqLimit_(p.req_size),
+      respLimit_(p.resp_size),
+      stats(this)
+{
+}
+
+void
+ThreadBridge::init()
+{
+    if (!crossQueue_)
+        return;
+
+    // Each side takes its mail on its own thread whenever the queues
+    // are synchronized
+    inQueue_->addSyncCallback([this]() { in_port_.takeMail(); });
+    outQueue_->addSyncCallback([this]() { out_port_.takeMail(); });
+}
+
+void
+ThreadBridge::Mailbox::push(const Message &msg)
+{
+    panic_if(!ring.push(msg), "ThreadBridge mailbox overflow, more "
+             "messages in flight than credits.");
+}
+
+bool
+ThreadBridge::Mailbox::take(Tick before, Message &msg)
+{
+    // One thread sends, so the messages are in send order
+    const Message *next = ring.front();
+    if (!next || next->sent >= before)
+        return false;
+
+    msg = *next;
+    ring.pop();
+    return true;
+}
+
+ThreadBridge::Arrivals::Arrivals(const std::string &name,
+                                 std::function<void()> callback)
+    : event(callback, name)
+{
+}
+
+void
+ThreadBridge::Arrivals::insert(EventQueue *eventq, const Message &msg)
+{
+    // Messages with the same arrival tick keep their order
+    auto pos = std::upper_bound(messages.begin(), messages.end(), msg.when,
+        [](Tick when, const Message &m) { return when < m.when; });
+    bool first = pos == messages.begin();
+    messages.insert(pos, msg);
+
+    if (first)
+        eventq->reschedule(&event, msg.when, true);
+}
+
+bool
+ThreadBridge::Arrivals::due() const
+{
+    return !messages.empty() && messages.front().when <= curTick();
+}
+
+ThreadBridge::Message
+ThreadBridge::Arrivals::pop()
 {
+    Message msg = messages.front();
+    messages.pop_front();
+    return msg;
+}
+
+void
+ThreadBridge::Arrivals::scheduleNext(EventQueue *eventq)
+{
+    if (!messages.empty()) {
+        eventq->reschedule(&event, std::max(messages.front().when,
+                                            curTick()), true);
+    }
 }
 
 ThreadBridge::IncomingPort::IncomingPort(const std::string &name,
-                                         ThreadBridge &device)
-    : ResponsePort(name), device_(device)
+                                         ThreadBridge &device,
+                                         unsigned credits,
+                                         unsigned responses)
+    : ResponsePort(name), device_(device),
+      // every credit and every reserved response can be on its way back
+      inbox_(credits + responses),
+      arrivals_(name + ".arrivals", [this]() { processArrivals(); }),
+      credits_(credits)
 {
 }
 
@@ -54,12 +147,121 @@ ThreadBridge::IncomingPort::getAddrRanges() const
 bool
 ThreadBridge::IncomingPort::recvTimingReq(PacketPtr pkt)
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    fatal_if(device_.crossQueue_ && device_.delay_ < simQuantum,
+             "%s: timing accesses between event queues need a delay of at "
+             "least the simulation quantum (%d ticks).", device_.name(),
+             simQuantum);
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    // keep refusing until the stalled request has been retried
+    if (retryReq_)
+        return false;
+
+    bool expects_response = pkt->needsResponse();
+    if (credits_ == 0 ||
+        (expects_response && outstandingResponses_ == device_.respLimit_)) {
+        DPRINTF(ThreadBridge, "Stall %s addr %#x, credits %d outstanding "
+                "%d\n", pkt->cmdString(), pkt->getAddr(), credits_,
+                outstandingResponses_);
+        retryReq_ = true;
+        ++device_.stats.stalls;
+        return false;
+    }
+
+    --credits_;
+    if (expects_response)
+        ++outstandingResponses_;
+
+    // as in Bridge, the packet only fully arrives after its header and
+    // payload delay
+    Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    DPRINTF(ThreadBridge, "Send %s addr %#x\n", pkt->cmdString(),
+            pkt->getAddr());
+    device_.out_port_.receive(
+        {curTick(), curTick() + device_.delay_ + receive_delay, pkt});
+    return true;
 }
+
 void
 ThreadBridge::IncomingPort::recvRespRetry()
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    waitingRespRetry_ = false;
+    trySendResponses();
+    retryStalledReq();
+}
+
+void
+ThreadBridge::IncomingPort::receive(const Message &msg)
+{
+    if (device_.crossQueue_)
+        inbox_.push(msg);
+    else
+        arrivals_.insert(device_.inQueue_, msg);
+}
+
+void
+ThreadBridge::IncomingPort::takeMail()
+{
+    Message msg;
+    while (inbox_.take(curTick(), msg)) {
+        panic_if(msg.when < curTick(), "%s: message for tick %d taken at "
+                 "%d, the delay is shorter than the quantum.", name(),
+                 msg.when, curTick());
+        arrivals_.insert(device_.inQueue_, msg);
+    }
+}
+
+void
+ThreadBridge::IncomingPort::processArrivals()
+{
+    while (arrivals_.due()) {
+        Message msg = arrivals_.pop();
+        if (msg.pkt) {
+            responses_.push_back(msg.pkt);
+        } else {
+            assert(credits_ < device_.reqLimit_);
+            ++credits_;
+        }
+    }
+    arrivals_.scheduleNext(device_.inQueue_);
+
+    trySendResponses();
+    retryStalledReq();
+}
+
+void
+ThreadBridge::IncomingPort::trySendResponses()
+{
+    while (!waitingRespRetry_ && !responses_.empty()) {
+        PacketPtr pkt = responses_.front();
+        DPRINTF(ThreadBridge, "Return %s addr %#x\n", pkt->cmdString(),
+                pkt->getAddr());
+        if (!sendTimingResp(pkt)) {
+            // try again on the retry
+            waitingRespRetry_ = true;
+            return;
+        }
+
+        responses_.pop_front();
+        assert(outstandingResponses_ != 0);
+        --outstandingResponses_;
+        ++device_.stats.responses;
+    }
+}
+
+void
+ThreadBridge::IncomingPort::retryStalledReq()
+{
+    // the stalled request may need a response slot, so wait for both
+    if (retryReq_ && credits_ > 0 &&
+        outstandingResponses_ < device_.respLimit_) {
+        DPRINTF(ThreadBridge, "Request waiting for retry, now retrying\n");
+        retryReq_ = false;
+        sendRetryReq();
+    }
 }
 
 // AtomicResponseProtocol
@@ -79,8 +281,10 @@ ThreadBridge::IncomingPort::recvFunctional(PacketPtr pkt)
 }
 
 ThreadBridge::OutgoingPort::OutgoingPort(const std::string &name,
-                                         ThreadBridge &device)
-    : RequestPort(name), device_(device)
+                                         ThreadBridge &device,
+                                         unsigned requests)
+    : RequestPort(name), device_(device), inbox_(requests),
+      requests_(name + ".requests", [this]() { trySendRequest(); })
 {
 }
 
@@ -94,12 +298,74 @@ ThreadBridge::OutgoingPort::recvRangeChange()
 bool
 ThreadBridge::OutgoingPort::recvTimingResp(PacketPtr pkt)
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    // the in_port side reserved space when it accepted the request
+    Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    device_.in_port_.receive(
+        {curTick(), curTick() + device_.delay_ + receive_delay, pkt});
+    return true;
 }
+
 void
 ThreadBridge::OutgoingPort::recvReqRetry()
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    waitingReqRetry_ = false;
+    trySendRequest();
+}
+
+void
+ThreadBridge::OutgoingPort::receive(const Message &msg)
+{
+    if (device_.crossQueue_)
+        inbox_.push(msg);
+    else
+        requests_.insert(device_.outQueue_, msg);
+}
+
+void
+ThreadBridge::OutgoingPort::takeMail()
+{
+    Message msg;
+    while (inbox_.take(curTick(), msg)) {
+        panic_if(msg.when < curTick(), "%s: message for tick %d taken at "
+                 "%d, the delay is shorter than the quantum.", name(),
+                 msg.when, curTick());
+        // a request stuck waiting for a retry is due already, so new
+        // ones never get in front of it
+        requests_.insert(device_.outQueue_, msg);
+    }
+}
+
+void
+ThreadBridge::OutgoingPort::trySendRequest()
+{
+    while (!waitingReqRetry_ && requests_.due()) {
+        if (!sendTimingReq(requests_.peek().pkt)) {
+            // try again on the retry
+            waitingReqRetry_ = true;
+            return;
+        }
+
+        requests_.pop();
+        ++device_.stats.requests;
+        // the buffer slot is free again, tell the other side
+        device_.in_port_.receive(
+            {curTick(), curTick() + device_.delay_, nullptr});
+    }
+    requests_.scheduleNext(device_.outQueue_);
+}
+
+ThreadBridge::ThreadBridgeStats::ThreadBridgeStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(requests, statistics::units::Count::get(),
+               "Timing requests sent out of out_port"),
+      ADD_STAT(responses, statistics::units::Count::get(),
+               "Timing responses sent out of in_port"),
+      ADD_STAT(stalls, statistics::units::Count::get(),
+               "Timing requests refused for lack of credits or response "
+               "space")
+{
 }
 
 Port &
@@ -25,11 +25,17 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #ifndef __MEM_THREAD_BRIDGE_HH__
 #define __MEM_THREAD_BRIDGE_HH__
 
+#include <deque>
+
+#include "base/spsc_ring.hh"
+#include "base/statistics.hh"
 #include "mem/port.hh"
 #include "params/ThreadBridge.hh"
+#include "sim/eventq.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -43,11 +49,75 @@ class ThreadBridge : public SimObject
     Port &getPort(const std::string &if_name,
                   PortID idx = InvalidPortID) override;
 
+    void init() override;
+
   private:
+    /** A timing packet, or a request credit, on its way across. */
+    struct Message
+    {
+        /** Tick the message was sent at. */
+        Tick sent;
+        /** Tick the message arrives at. */
+        Tick when;
+        /** The packet, nullptr for a credit. */
+        PacketPtr pkt;
+    };
+
+    /**
+     * Messages from the thread of one side to the thread of the other,
+     * in a lock-free ring so neither thread ever blocks on the other.
+     * The credits bound the messages in flight, so the ring never fills.
+     * The receiver only takes the messages sent before the current
+     * synchronization tick, which all were sent by the time every queue
+     * reached the barrier, so it sees the same messages whatever the
+     * host thread timing.
+     */
+    class Mailbox
+    {
+      public:
+        explicit Mailbox(size_t capacity) : ring(capacity) {}
+
+        void push(const Message &msg);
+
+        /**
+         * Take the oldest message if it was sent before tick.
+         *
+         * @return False if there is no such message.
+         */
+        bool take(Tick before, Message &msg);
+
+      private:
+        SpscRing<Message> ring;
+    };
+
+    /**
+     * Messages that arrived at one side, ordered by arrival tick, and
+     * the event that handles the earliest one.
+     */
+    class Arrivals
+    {
+      public:
+        Arrivals(const std::string &name, std::function<void()> callback);
+
+        /** Add a message and make sure the event fires when it is due. */
+        void insert(EventQueue *eventq, const Message &msg);
+
+        bool due() const;
+        Message pop();
+        void scheduleNext(EventQueue *eventq);
+
+        const Message &peek() const { return messages.front(); }
+
+      private:
+        std::deque<Message> messages;
+        EventFunctionWrapper event;
+    };
+
     class IncomingPort : public ResponsePort
     {
       public:
-        IncomingPort(const std::string &name, ThreadBridge &device);
+        IncomingPort(const std::string &name, ThreadBridge &device,
+                     unsigned credits, unsigned responses);
         AddrRangeList getAddrRanges() const override;
 
         // TimingResponseProtocol
@@ -60,26 +130,84 @@ class ThreadBridge : public SimObject
         // FunctionalResponseProtocol
         void recvFunctional(PacketPtr pkt) override;
 
+        /** Take a response or credit from the other side. */
+        void receive(const Message &msg);
+
+        /** Take the messages the other side posted, at a sync point. */
+        void takeMail();
+
       private:
         ThreadBridge &device_;
+
+        Mailbox inbox_;
+        Arrivals arrivals_;
+
+        /** Responses that arrived and wait to be sent upstream. */
+        std::deque<PacketPtr> responses_;
+        bool waitingRespRetry_ = false;
+
+        /** Requests the other side can still buffer. */
+        unsigned credits_;
+        /** Requests accepted whose response has not been sent. */
+        unsigned outstandingResponses_ = 0;
+        /** A request was refused and waits for a retry. */
+        bool retryReq_ = false;
+
+        void processArrivals();
+        void trySendResponses();
+        void retryStalledReq();
     };
 
     class OutgoingPort : public RequestPort
     {
       public:
-        OutgoingPort(const std::string &name, ThreadBridge &device);
+        OutgoingPort(const std::string &name, ThreadBridge &device,
+                     unsigned requests);
         void recvRangeChange() override;
 
         // TimingRequestProtocol
         bool recvTimingResp(PacketPtr pkt) override;
         void recvReqRetry() override;
 
+        /** Take a request from the other side. */
+        void receive(const Message &msg);
+
+        /** Take the messages the other side posted, at a sync point. */
+        void takeMail();
+
       private:
         ThreadBridge &device_;
+
+        Mailbox inbox_;
+        Arrivals requests_;
+        bool waitingReqRetry_ = false;
+
+        void trySendRequest();
     };
 
     IncomingPort in_port_;
     OutgoingPort out_port_;
+
+    /** Queues of the in_port and out_port sides. */
+    EventQueue *inQueue_;
+    EventQueue *outQueue_;
+    /** Timing messages go through the mailboxes. */
+    const bool crossQueue_;
+
+    const Tick delay_;
+    const unsigned reqLimit_;
+    const unsigned respLimit_;
+
+    struct ThreadBridgeStats : public statistics::Group
+    {
+        ThreadBridgeStats(statistics::Group *parent);
+
+        /** Updated by the out_port thread. */
+        statistics::Scalar requests;
+        /** Updated by the in_port thread. */
+        statistics::Scalar responses;
+        statistics::Scalar stalls;
+    } stats;
 };
 
 }  // namespace gem5
@@ -31,6 +31,10 @@ from m5.SimObject import SimObject
 from m5.util import fatal
 
 
+class EventQueueScheduler(ScopedEnum):
+    vals = ["list", "calendar"]
+
+
 class Root(SimObject):
     _the_instance = None
 
@@ -70,6 +74,19 @@ class Root(SimObject):
 
     full_system = Param.Bool("if this is a full system simulation")
 
+    # Allocate Packets, Requests and packet data from per-thread slabs
+    # instead of the host allocator (see src/mem/packet_pool.hh). The
+    # packetPool.* statistics count the allocations either way.
+    packet_pool = Param.Bool(False, "allocate memory transactions from a pool")
+
+    # How each main event queue orders its pending events: a sorted list
+    # (insert is linear in the number of distinct (when, priority) bins)
+    # or a calendar queue (constant amortized insert and pop). Events are
+    # serviced in the same order either way.
+    eventq_scheduler = Param.EventQueueScheduler(
+        "list", "event queue scheduler backend"
+    )
+
     # Time syncing prevents the simulation from running faster than real time.
     time_sync_enable = Param.Bool(False, "whether time syncing is enabled")
     time_sync_period = Param.Clock("100ms", "how often to sync with real time")
@@ -49,6 +49,10 @@ class MemoryMode(Enum):
     vals = ["invalid", "atomic", "timing", "atomic_noncaching"]
 
 
+class SEThreadPlacement(ScopedEnum):
+    vals = ["first_free", "round_robin", "cluster"]
+
+
 class System(SimObject):
     type = "System"
     cxx_header = "sim/system.hh"
@@ -142,6 +146,27 @@ class System(SimObject):
     work_cpus_ckpt_count = Param.Counter(
         0, "create checkpoint when active cpu count value is reached"
     )
+    roi_stats = Param.Bool(
+        False,
+        "Reset the statistics at the first work_begin and dump them when "
+        "the last hart leaves the region of interest with work_end",
+    )
+    thread_placement = Param.SEThreadPlacement(
+        "first_free",
+        "How clone picks the hart of a new thread in SE mode: the first "
+        "free hart, round robin from the last placed hart, or a free hart "
+        "in the parent's cluster before the cluster with most free harts",
+    )
+    harts_per_cluster = Param.Unsigned(
+        0,
+        "Harts per cluster for the cluster placement, 0 puts all harts in "
+        "one cluster",
+    )
+    roi_threads = Param.Int(
+        0,
+        "Number of harts that must enter the region of interest before it "
+        "can close, 0 closes it as soon as no hart is inside",
+    )
 
     workload = Param.Workload(StubWorkload(), "Workload to run on this system")
     init_param = Param.UInt64(0, "numerical value to pass into simulator")
@@ -0,0 +1,246 @@
+#include "sim/calendar_queue.hh"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/logging.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+bool
+binBefore(const Event *l, const Event *r)
+{
+    return *l < *r;
+}
+
+} // anonymous namespace
+
+CalendarQueue::CalendarQueue()
+    : buckets(MinBuckets, nullptr)
+{
+}
+
+void
+CalendarQueue::moveCursor(Tick when)
+{
+    if (when < cursorStart) {
+        cursorStart = when / width * width;
+        cursor = bucketOf(when);
+    }
+}
+
+void
+CalendarQueue::link(Event *bin)
+{
+    Event **pos = &buckets[bucketOf(bin->when())];
+    while (*pos && **pos < *bin)
+        pos = &(*pos)->nextBin;
+
+    bin->nextBin = *pos;
+    *pos = bin;
+    numBins++;
+    moveCursor(bin->when());
+}
+
+void
+CalendarQueue::insert(Event *event)
+{
+    Event **pos = &buckets[bucketOf(event->when())];
+    while (*pos && **pos < *event)
+        pos = &(*pos)->nextBin;
+
+    bool new_bin = !*pos || *event < **pos;
+    *pos = Event::insertBefore(event, *pos);
+    if (!new_bin)
+        return;
+
+    numBins++;
+    moveCursor(event->when());
+    if (numBins > 2 * buckets.size())
+        resize(2 * buckets.size());
+}
+
+void
+CalendarQueue::insertBin(Event *bin)
+{
+    link(bin);
+    if (numBins > 2 * buckets.size())
+        resize(2 * buckets.size());
+}
+
+void
+CalendarQueue::remove(Event *event)
+{
+    Event **pos = &buckets[bucketOf(event->when())];
+    while (*pos && **pos < *event)
+        pos = &(*pos)->nextBin;
+
+    if (!*pos || **pos != *event)
+        panic("event not found!");
+
+    Event *top = *pos;
+    bool last = event == top && !top->nextInBin;
+    *pos = Event::removeItem(event, top);
+    if (last) {
+        numBins--;
+        shrink();
+    }
+}
+
+Event *
+CalendarQueue::popBin()
+{
+    if (!numBins)
+        return nullptr;
+
+    const size_t mask = buckets.size() - 1;
+    Event *bin = nullptr;
+
+    // Walk one year of days from the current one. All bins are at or
+    // after cursorStart, so the first bin within its day is the earliest.
+    for (size_t i = 0; i < buckets.size(); i++) {
+        Event *first = buckets[cursor];
+        if (first && first->when() - cursorStart < width) {
+            bin = first;
+            break;
+        }
+        if (cursorStart > MaxTick - width)
+            break;
+        cursor = (cursor + 1) & mask;
+        cursorStart += width;
+    }
+
+    if (!bin) {
+        // The next bin is more than a year away: take the earliest
+        // first bin of all buckets and jump to its day.
+        for (size_t i = 0; i < buckets.size(); i++) {
+            if (buckets[i] && (!bin || *buckets[i] < *bin)) {
+                bin = buckets[i];
+                cursor = i;
+            }
+        }
+        cursorStart = bin->when() / width * width;
+        directSearches++;
+    }
+
+    buckets[cursor] = bin->nextBin;
+    bin->nextBin = nullptr;
+    numBins--;
+
+    if (directSearches >= ReestimateAfter)
+        resize(buckets.size());
+    else
+        shrink();
+
+    return bin;
+}
+
+void
+CalendarQueue::shrink()
+{
+    if (buckets.size() > MinBuckets && numBins < buckets.size() / 2)
+        resize(buckets.size() / 2);
+}
+
+void
+CalendarQueue::resize(size_t num_buckets)
+{
+    std::vector<Event *> all;
+    all.reserve(numBins);
+    for (Event *first : buckets) {
+        for (Event *bin = first; bin; bin = bin->nextBin)
+            all.push_back(bin);
+    }
+
+    std::vector<Tick> ticks;
+    ticks.reserve(all.size());
+    for (Event *bin : all)
+        ticks.push_back(bin->when());
+    width = estimateWidth(ticks, width);
+
+    buckets.assign(num_buckets, nullptr);
+    numBins = 0;
+    directSearches = 0;
+    // Restart at the day of the earliest bin
+    Tick first = ticks.empty() ? 0 : ticks[0];
+    cursorStart = first / width * width;
+    cursor = bucketOf(first);
+    for (Event *bin : all)
+        link(bin);
+}
+
+Tick
+CalendarQueue::estimateWidth(std::vector<Tick> &ticks, Tick fallback)
+{
+    // Bins at the same tick with different priorities are the normal
+    // case, e.g. CPU_Tick_Pri and Default_Pri events on every clock edge.
+    // Their zero gaps would pull the width down to one tick, so sample
+    // distinct ticks and sort further while there are too few.
+    const size_t samples = 32;
+    std::vector<Tick> distinct;
+    size_t sorted = 0;
+    do {
+        sorted = std::min(ticks.size(), std::max(samples, 2 * sorted));
+        std::partial_sort(ticks.begin(), ticks.begin() + sorted,
+                          ticks.end());
+        distinct.clear();
+        std::unique_copy(ticks.begin(), ticks.begin() + sorted,
+                         std::back_inserter(distinct));
+    } while (distinct.size() < samples && sorted < ticks.size());
+
+    if (distinct.size() > samples)
+        distinct.resize(samples);
+    if (distinct.size() < 2)
+        return fallback;
+
+    Tick span = distinct.back() - distinct.front();
+    Tick average = span / (distinct.size() - 1);
+    Tick sum = 0;
+    size_t gaps = 0;
+    for (size_t i = 1; i < distinct.size(); i++) {
+        Tick gap = distinct[i] - distinct[i - 1];
+        if (gap <= 2 * average) {
+            sum += gap;
+            gaps++;
+        }
+    }
+    return gaps ? std::max<Tick>(1, 3 * (sum / gaps)) : fallback;
+}
+
+Event *
+CalendarQueue::drain()
+{
+    std::vector<Event *> sorted = bins();
+    Event *list = nullptr;
+    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+        (*it)->nextBin = list;
+        list = *it;
+    }
+
+    buckets.assign(MinBuckets, nullptr);
+    numBins = 0;
+    cursor = 0;
+    cursorStart = 0;
+    directSearches = 0;
+    return list;
+}
+
+std::vector<Event *>
+CalendarQueue::bins() const
+{
+    std::vector<Event *> all;
+    all.reserve(numBins);
+    for (Event *first : buckets) {
+        for (Event *bin = first; bin; bin = bin->nextBin)
+            all.push_back(bin);
+    }
+    std::sort(all.begin(), all.end(), binBefore);
+    return all;
+}
+
+} // namespace gem5
@@ -0,0 +1,109 @@
+#ifndef __SIM_CALENDAR_QUEUE_HH__
+#define __SIM_CALENDAR_QUEUE_HH__
+
+#include <cstddef>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+class Event;
+
+/**
+ * Calendar queue (R. Brown, CACM 1988) of event bins, the alternative
+ * to the sorted nextBin list of EventQueue.
+ *
+ * A bin is the LIFO stack of events with the same (when, priority),
+ * represented by its top event exactly as in the list; the queue only
+ * changes how the bins are found. Time is cut into days of `width`
+ * ticks which are hashed onto a power-of-two number of buckets. Each
+ * bucket holds a short sorted list of bins linked by nextBin. Dequeue
+ * walks the buckets day by day from the day of the last dequeued bin.
+ * The number of buckets follows the number of bins and the day width
+ * is re-estimated from the gaps between the earliest bins on every
+ * resize, so insert and pop are O(1) amortized.
+ */
+class CalendarQueue
+{
+  public:
+    CalendarQueue();
+
+    /**
+     * Add an event, on top of the bin with the same when and priority
+     * if there is one.
+     */
+    void insert(Event *event);
+
+    /** Add a whole bin; no bin with the same key may be queued. */
+    void insertBin(Event *bin);
+
+    void remove(Event *event);
+
+    /**
+     * Remove the earliest bin.
+     *
+     * @return Its top event with nextBin cleared, nullptr if empty.
+     */
+    Event *popBin();
+
+    /** Remove all bins and return them as a sorted nextBin list. */
+    Event *drain();
+
+    /** Top events of all bins in time order, for dumps and checks. */
+    std::vector<Event *> bins() const;
+
+    bool empty() const { return numBins == 0; }
+    size_t size() const { return numBins; }
+
+    /**
+     * Brown's day width estimate: three times the average gap between
+     * the earliest distinct ticks, leaving out gaps of more than twice
+     * the average.
+     *
+     * @param ticks The when of every bin, reordered so that the earliest
+     *     comes first.
+     * @param fallback Width to keep if there are fewer than two distinct
+     *     ticks.
+     */
+    static Tick estimateWidth(std::vector<Tick> &ticks, Tick fallback);
+
+  private:
+    static constexpr size_t MinBuckets = 16;
+
+    /**
+     * Direct searches (a whole year of buckets without the next bin)
+     * after which the day width is re-estimated.
+     */
+    static constexpr unsigned ReestimateAfter = 8;
+
+    std::vector<Event *> buckets;
+    Tick width = 1;
+    size_t numBins = 0;
+
+    /** Bucket of the current day and the first tick of that day. */
+    size_t cursor = 0;
+    Tick cursorStart = 0;
+
+    unsigned directSearches = 0;
+
+    size_t
+    bucketOf(Tick when) const
+    {
+        return (when / width) & (buckets.size() - 1);
+    }
+
+    /** Link a new bin into its bucket without resizing. */
+    void link(Event *bin);
+
+    /** Make sure the current day is not after a new bin. */
+    void moveCursor(Tick when);
+
+    void resize(size_t num_buckets);
+    void shrink();
+};
+
+} // namespace gem5
+
+#endif // __SIM_CALENDAR_QUEUE_HH__
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Logs its id when processed and schedules itself again a random
+ * number of ticks later until its repeats run out.
+ */
+class LogEvent : public Event
+{
+  public:
+    LogEvent(int _id, Priority pri, int _repeats, EventQueue &_queue,
+             std::mt19937 &_rng, std::vector<int> &_log)
+        : Event(pri), id(_id), repeats(_repeats), queue(_queue), rng(_rng),
+          log(_log)
+    {}
+
+    void
+    process() override
+    {
+        log.push_back(id);
+        if (repeats-- > 0)
+            queue.schedule(this, queue.getCurTick() + rng() % 50);
+    }
+
+  private:
+    int id;
+    int repeats;
+    EventQueue &queue;
+    std::mt19937 &rng;
+    std::vector<int> &log;
+};
+
+const int NumEvents = 2000;
+const Tick Horizon = 500;
+
+/**
+ * Schedule, deschedule and reschedule events on a queue using the given
+ * scheduler. Times and priorities collide often, so the bins hold
+ * several events and their LIFO order is exercised too.
+ *
+ * @param switch_at Toggle the scheduler after this many serviced
+ *     events, -1 to keep it.
+ * @return The ids of the events in service order.
+ */
+std::vector<int>
+run(EventQueue::Scheduler scheduler, unsigned seed, int switch_at = -1)
+{
+    EventQueue queue("test");
+    curEventQueue(&queue);
+    queue.setScheduler(scheduler);
+
+    std::mt19937 rng(seed);
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    for (int i = 0; i < NumEvents; i++) {
+        Event::Priority pri = rng() % 3;
+        events.emplace_back(
+            new LogEvent(i, pri, rng() % 4, queue, rng, log));
+        queue.schedule(events.back().get(), rng() % Horizon);
+    }
+
+    for (int i = 0; i < NumEvents / 4; i++) {
+        LogEvent *event = events[rng() % NumEvents].get();
+        if (rng() % 2) {
+            if (event->scheduled())
+                queue.deschedule(event);
+        } else {
+            queue.reschedule(event, rng() % Horizon, true);
+        }
+    }
+
+    int serviced = 0;
+    while (!queue.empty()) {
+        if (serviced % 64 == 0)
+            EXPECT_TRUE(queue.debugVerify());
+        queue.serviceOne();
+        if (++serviced == switch_at) {
+            queue.setScheduler(
+                queue.scheduler() == EventQueue::Scheduler::List ?
+                EventQueue::Scheduler::Calendar :
+                EventQueue::Scheduler::List);
+        }
+    }
+
+    curEventQueue(nullptr);
+    return log;
+}
+
+} // anonymous namespace
+
+TEST(CalendarQueueTest, SameOrderAsList)
+{
+    for (unsigned seed = 1; seed <= 4; seed++) {
+        std::vector<int> list = run(EventQueue::Scheduler::List, seed);
+        EXPECT_EQ(list, run(EventQueue::Scheduler::Calendar, seed));
+    }
+}
+
+TEST(CalendarQueueTest, SwitchScheduler)
+{
+    std::vector<int> list = run(EventQueue::Scheduler::List, 7);
+    EXPECT_EQ(list, run(EventQueue::Scheduler::List, 7, NumEvents / 2));
+    EXPECT_EQ(list, run(EventQueue::Scheduler::Calendar, 7, NumEvents / 2));
+}
+
+TEST(CalendarQueueTest, ReplaceHead)
+{
+    EventQueue queue("test");
+    curEventQueue(&queue);
+    queue.setScheduler(EventQueue::Scheduler::Calendar);
+
+    std::mt19937 rng(3);
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    for (int i = 0; i < 100; i++) {
+        events.emplace_back(new LogEvent(i, 0, 0, queue, rng, log));
+        queue.schedule(events.back().get(), (i * 37) % 20);
+    }
+
+    // The saved head carries the whole queue and can be put back
+    Event *saved = queue.replaceHead(nullptr);
+    ASSERT_NE(saved, nullptr);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.replaceHead(saved), nullptr);
+
+    std::vector<int> expected;
+    for (int when = 0; when < 20; when++) {
+        // Events of a bin are serviced last scheduled first
+        for (int i = 99; i >= 0; i--) {
+            if ((i * 37) % 20 == when)
+                expected.push_back(i);
+        }
+    }
+    while (!queue.empty())
+        queue.serviceOne();
+    EXPECT_EQ(log, expected);
+
+    curEventQueue(nullptr);
+}
+
+TEST(CalendarQueueTest, WidthFromDistinctTicks)
+{
+    // Two priorities on every 500-tick clock edge: the zero gaps between
+    // the bins of an edge must not count
+    std::vector<Tick> ticks;
+    for (Tick edge = 0; edge < 100; edge++) {
+        ticks.push_back(edge * 500);
+        ticks.push_back(edge * 500);
+    }
+    std::shuffle(ticks.begin(), ticks.end(), std::mt19937(5));
+    EXPECT_EQ(CalendarQueue::estimateWidth(ticks, 1), 1500);
+    EXPECT_EQ(ticks[0], 0);
+
+    // More bins per tick than samples
+    ticks.assign(100, 1000);
+    ticks.push_back(1010);
+    ticks.push_back(1020);
+    EXPECT_EQ(CalendarQueue::estimateWidth(ticks, 1), 30);
+
+    // A single tick keeps the old width
+    ticks.assign(10, 42);
+    EXPECT_EQ(CalendarQueue::estimateWidth(ticks, 7), 7);
+    ticks.clear();
+    EXPECT_EQ(CalendarQueue::estimateWidth(ticks, 7), 7);
+}
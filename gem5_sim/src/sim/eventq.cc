@@ -58,6 +58,9 @@ std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+static EventQueue::Scheduler mainEventQueueScheduler =
+    EventQueue::Scheduler::List;
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
@@ -65,11 +68,20 @@ getEventQueue(uint32_t index)
         numMainEventQueues++;
         mainEventQueue.push_back(
             new EventQueue(csprintf("MainEventQueue-%d", index)));
+        mainEventQueue.back()->setScheduler(mainEventQueueScheduler);
     }
 
     return mainEventQueue[index];
 }
 
+void
+setEventQueueScheduler(EventQueue::Scheduler scheduler)
+{
+    mainEventQueueScheduler = scheduler;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setScheduler(scheduler);
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -137,6 +149,21 @@ Event::releaseImpl()
 void
 EventQueue::insert(Event *event)
 {
+    if (_scheduler == Scheduler::Calendar) {
+        // The head bin stays out of the calendar: an earlier event
+        // pushes it back in, a later one goes to the calendar.
+        if (head && *event > *head) {
+            calendar.insert(event);
+            return;
+        }
+        if (head && *event < *head) {
+            calendar.insertBin(head);
+            head = nullptr;
+        }
+        head = Event::insertBefore(event, head);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -200,6 +227,13 @@ EventQueue::remove(Event *event)
     // time as the head)
     if (*head == *event) {
         head = Event::removeItem(event, head);
+        if (!head && _scheduler == Scheduler::Calendar)
+            head = calendar.popBin();
+        return;
+    }
+
+    if (_scheduler == Scheduler::Calendar) {
+        calendar.remove(event);
         return;
     }
 
@@ -234,6 +268,9 @@ EventQueue::serviceOne()
 
         // pop the stack
         head = next;
+    } else if (_scheduler == Scheduler::Calendar) {
+        // the head bin is empty, take the earliest bin of the calendar
+        head = calendar.popBin();
     } else {
         // this was the only element on the 'in bin' list, so get rid of
         // the 'in bin' list and point to the next bin list
@@ -321,15 +358,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
+        for (Event *bin : bins()) {
+            Event *nextInBin = bin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -344,9 +378,8 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    for (Event *bin : bins()) {
+        Event *nextInBin = bin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
@@ -371,21 +404,62 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
 }
 
+std::vector<Event *>
+EventQueue::bins() const
+{
+    std::vector<Event *> all;
+    if (_scheduler == Scheduler::Calendar) {
+        if (head)
+            all.push_back(head);
+        std::vector<Event *> rest = calendar.bins();
+        all.insert(all.end(), rest.begin(), rest.end());
+    } else {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            all.push_back(bin);
+    }
+    return all;
+}
+
 Event*
 EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
+    if (_scheduler == Scheduler::Calendar) {
+        // Hand out and take back the whole queue as a nextBin list
+        if (t)
+            t->nextBin = calendar.drain();
+        head = s;
+        if (s) {
+            for (Event *bin = s->nextBin, *next; bin; bin = next) {
+                next = bin->nextBin;
+                calendar.insertBin(bin);
+            }
+            s->nextBin = nullptr;
+        }
+        return t;
+    }
+
     head = s;
     return t;
 }
 
+void
+EventQueue::setScheduler(Scheduler scheduler)
+{
+    if (scheduler == _scheduler)
+        return;
+
+    // Take the queue apart as a sorted nextBin list and rebuild it
+    Event *list = replaceHead(nullptr);
+    _scheduler = scheduler;
+    replaceHead(list);
+}
+
 void
 dumpMainQueue()
 {
@@ -442,7 +516,7 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), _scheduler(Scheduler::List)
 {
 }
 
@@ -468,4 +542,18 @@ EventQueue::handleAsyncInsertions()
     async_queue_mutex.unlock();
 }
 
+void
+EventQueue::addSyncCallback(std::function<void()> callback)
+{
+    syncCallbacks.push_back(std::move(callback));
+}
+
+void
+EventQueue::processSyncCallbacks()
+{
+    assert(this == curEventQueue());
+    for (auto &callback : syncCallbacks)
+        callback();
+}
+
 } // namespace gem5
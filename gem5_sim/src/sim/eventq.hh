@@ -43,6 +43,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -52,6 +53,7 @@
 #include "base/types.hh"
 #include "base/uncontended_mutex.hh"
 #include "debug/Event.hh"
+#include "sim/calendar_queue.hh"
 #include "sim/cur_tick.hh"
 #include "sim/serialize.hh"
 
@@ -254,6 +256,7 @@ class EventBase
 class Event : public EventBase, public Serializable
 {
     friend class EventQueue;
+    friend class CalendarQueue;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -617,16 +620,38 @@ class EventQueue
   private:
     friend void curEventQueue(EventQueue *);
 
+  public:
+    /**
+     * How the bins after the head are kept: the sorted nextBin list
+     * (O(number of bins) insert) or a CalendarQueue (O(1) amortized).
+     * Both service events in the same order.
+     */
+    enum class Scheduler
+    {
+        List,
+        Calendar
+    };
+
+  private:
     std::string objName;
     Event *head;
     Tick _curTick;
 
+    Scheduler _scheduler;
+
+    //! Bins after the head when the Calendar scheduler is selected.
+    //! The head bin is never in the calendar and its nextBin is null.
+    CalendarQueue calendar;
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
     //! List of events added by other threads to this event queue.
     std::list<Event*> async_queue;
 
+    //! Functions run by processSyncCallbacks(), see addSyncCallback().
+    std::vector<std::function<void()>> syncCallbacks;
+
     /**
      * Lock protecting event handling.
      *
@@ -850,6 +875,14 @@ class EventQueue
     Tick getCurTick() const { return _curTick; }
     Event *getHead() const { return head; }
 
+    Scheduler scheduler() const { return _scheduler; }
+
+    /**
+     * Switch the scheduler, moving the queued events over in order.
+     * Should only be called by the thread operating this queue.
+     */
+    void setScheduler(Scheduler scheduler);
+
     Event *serviceOne();
 
     /**
@@ -905,6 +938,19 @@ class EventQueue
      */
     void handleAsyncInsertions();
 
+    /**
+     * Register a function to run on the thread of this queue whenever
+     * all queues stand at the same tick: when simulate() enters the
+     * event loop and after every quantum barrier, once the asynchronous
+     * insertions are in. Objects that pass data between queues pick it
+     * up there, at ticks that do not depend on host thread timing.
+     * Callbacks must be registered before the simulation starts.
+     */
+    void addSyncCallback(std::function<void()> callback);
+
+    /** Run the addSyncCallback() functions in registration order. */
+    void processSyncCallbacks();
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -966,8 +1012,16 @@ class EventQueue
         while (!empty())
             deschedule(getHead());
     }
+
+  private:
+    //! Top events of all bins in service order
+    std::vector<Event *> bins() const;
 };
 
+//! Select the scheduler of all main event queues, including the ones
+//! created later.
+void setEventQueueScheduler(EventQueue::Scheduler scheduler);
+
 inline void
 curEventQueue(EventQueue *q)
 {
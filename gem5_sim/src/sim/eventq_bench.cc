@@ -0,0 +1,134 @@
+/*
+ * Event queue scheduler microbenchmark.
+ *
+ * Classic hold model: the queue is filled with n pending events, then
+ * every serviced event schedules itself again a random number of
+ * cycles later, so the queue stays at n events. As in a simulated
+ * system, events land on clock edges and an edge holds several
+ * priorities, e.g. CPU_Tick_Pri and Default_Pri. Reports the time per
+ * hold operation (one pop plus one insert) for the list and calendar
+ * schedulers at 10^3 .. max_pending pending events:
+ *
+ *   eventq_bench [max_pending] [seconds per point]
+ *
+ * Each point stops after 10^6 operations or the time budget, whichever
+ * comes first, since the list needs milliseconds per operation at 10^6
+ * pending events.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const Tick Period = 500;
+
+const Event::Priority Priorities[] = {
+    Event::Delayed_Writeback_Pri, Event::Default_Pri, Event::CPU_Tick_Pri,
+    Event::Stat_Event_Pri
+};
+const size_t NumPriorities = sizeof(Priorities) / sizeof(Priorities[0]);
+
+class HoldEvent : public Event
+{
+  public:
+    HoldEvent(EventQueue &_queue, std::mt19937_64 &_rng, Tick _spread,
+              Priority pri)
+        : Event(pri), queue(_queue), rng(_rng), spread(_spread)
+    {}
+
+    void
+    process() override
+    {
+        queue.schedule(this, queue.getCurTick() +
+                       Period * (1 + rng() % spread));
+    }
+
+  private:
+    EventQueue &queue;
+    std::mt19937_64 &rng;
+    Tick spread;
+};
+
+/** @return Nanoseconds per hold operation. */
+double
+hold(EventQueue::Scheduler scheduler, size_t pending, double seconds)
+{
+    EventQueue queue("bench");
+    curEventQueue(&queue);
+    queue.setScheduler(scheduler);
+
+    // Events land up to pending / 4 cycles ahead, so almost every clock
+    // edge holds events, mostly of several priorities
+    std::mt19937_64 rng(1);
+    const Tick spread = std::max<Tick>(1, pending / 4);
+    std::vector<std::unique_ptr<HoldEvent>> events;
+    std::vector<Tick> when(pending);
+    for (size_t i = 0; i < pending; i++) {
+        events.emplace_back(new HoldEvent(queue, rng, spread,
+                                          Priorities[i % NumPriorities]));
+        when[i] = Period * (rng() % spread);
+    }
+    // Filling latest first puts every event at the head of the list
+    std::sort(when.begin(), when.end(), std::greater<Tick>());
+    for (size_t i = 0; i < pending; i++)
+        queue.schedule(events[i].get(), when[i]);
+
+    // Run in chunks until max_ops or the budget is spent
+    using Clock = std::chrono::steady_clock;
+    auto run = [&queue](uint64_t max_ops, double budget) {
+        const uint64_t chunk = 100;
+        auto start = Clock::now();
+        double elapsed = 0;
+        uint64_t done = 0;
+        while (done < max_ops && elapsed < budget) {
+            for (uint64_t i = 0; i < chunk; i++)
+                queue.serviceOne();
+            done += chunk;
+            elapsed = std::chrono::duration<double>(
+                Clock::now() - start).count();
+        }
+        return std::make_pair(done, elapsed);
+    };
+
+    run(std::min<uint64_t>(pending, 10000), seconds / 10);
+    auto [ops, elapsed] = run(1000000, seconds);
+
+    while (!queue.empty())
+        queue.deschedule(queue.getHead());
+    curEventQueue(nullptr);
+    return elapsed * 1e9 / ops;
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+    size_t max_pending = argc > 1 ? std::strtoull(argv[1], nullptr, 0) :
+                                    1000000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+
+    cprintf("%10s %14s %14s %10s\n", "pending", "list ns/op",
+            "calendar ns/op", "speedup");
+    for (size_t pending = 1000; pending <= max_pending; pending *= 10) {
+        double list = hold(EventQueue::Scheduler::List, pending, seconds);
+        double calendar = hold(EventQueue::Scheduler::Calendar, pending,
+                               seconds);
+        cprintf("%10d %14.1f %14.1f %9.1fx\n", pending, list, calendar,
+                list / calendar);
+    }
+
+    return 0;
+}
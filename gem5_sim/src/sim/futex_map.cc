@@ -40,15 +40,98 @@ FutexKey::operator==(const FutexKey &in) const
     return addr == in.addr && tgid == in.tgid;
 }
 
-WaiterState::WaiterState(ThreadContext* _tc, int _bitmask)
-      : tc(_tc), bitmask(_bitmask) { }
-
 bool
 WaiterState::checkMask(int wakeup_bitmask) const
 {
     return bitmask & wakeup_bitmask;
 }
 
+void
+WaitQueue::push(WaiterState *w)
+{
+    w->queue = this;
+    w->prev = tail;
+    w->next = nullptr;
+    if (tail)
+        tail->next = w;
+    else
+        head = w;
+    tail = w;
+    size++;
+}
+
+void
+WaitQueue::remove(WaiterState *w)
+{
+    assert(w->queue == this);
+    if (w->prev)
+        w->prev->next = w->next;
+    else
+        head = w->next;
+    if (w->next)
+        w->next->prev = w->prev;
+    else
+        tail = w->prev;
+    w->queue = nullptr;
+    w->prev = w->next = nullptr;
+    size--;
+}
+
+FutexMap::FutexMap(statistics::Group *parent)
+    : stats(parent)
+{
+}
+
+FutexMap::FutexStats::FutexStats(statistics::Group *parent)
+    : statistics::Group(parent, "futex"),
+      ADD_STAT(waits, statistics::units::Count::get(),
+               "Number of threads suspended on a futex"),
+      ADD_STAT(wakeups, statistics::units::Count::get(),
+               "Number of threads woken up from a futex"),
+      ADD_STAT(requeues, statistics::units::Count::get(),
+               "Number of threads moved to another futex by requeue"),
+      ADD_STAT(emptyWakes, statistics::units::Count::get(),
+               "Number of wake operations that found no waiter"),
+      ADD_STAT(queueLength, statistics::units::Count::get(),
+               "Threads already waiting on the futex when a thread waits"),
+      ADD_STAT(waitsPerAddr, statistics::units::Count::get(),
+               "Number of waits on each futex address"),
+      ADD_STAT(waitTicksPerAddr, statistics::units::Tick::get(),
+               "Ticks threads spent waiting on each futex address")
+{
+    queueLength.init(0, 63, 1);
+    waitsPerAddr.init(0);
+    waitTicksPerAddr.init(0);
+}
+
+WaitQueue *
+FutexMap::findQueue(Addr addr, uint64_t tgid)
+{
+    auto it = queues.find(FutexKey(addr, tgid));
+    return it == queues.end() ? nullptr : &it->second;
+}
+
+WaiterState &
+FutexMap::waiter(ThreadContext *tc)
+{
+    ContextID id = tc->contextId();
+    if (id >= (ContextID)waiters.size())
+        waiters.resize(id + 1);
+    WaiterState &w = waiters[id];
+    w.tc = tc;
+    return w;
+}
+
+void
+FutexMap::wake(WaiterState *w)
+{
+    WaitQueue *queue = w->queue;
+    queue->remove(w);
+    stats.wakeups++;
+    stats.waitTicksPerAddr.sample(queue->addr, curTick() - w->waitTick);
+    w->tc->activate();
+}
+
 void
 FutexMap::suspend(Addr addr, uint64_t tgid, ThreadContext *tc)
 {
@@ -58,30 +141,23 @@ FutexMap::suspend(Addr addr, uint64_t tgid, ThreadContext *tc)
 int
 FutexMap::wakeup(Addr addr, uint64_t tgid, int count)
 {
-    FutexKey key(addr, tgid);
-    auto it = find(key);
-
-    if (it == end())
+    WaitQueue *queue = findQueue(addr, tgid);
+    if (!queue || queue->empty()) {
+        stats.emptyWakes++;
         return 0;
+    }
 
     int woken_up = 0;
-    auto &waiterList = it->second;
 
-    while (!waiterList.empty() && woken_up < count) {
+    while (!queue->empty() && woken_up < count) {
         // Threads may be woken up by access to locked
         // memory addresses outside of syscalls, so we
         // must only count threads that were actually
         // woken up by this syscall.
-        auto& tc = waiterList.front().tc;
-        tc->activate();
+        wake(queue->head);
         woken_up++;
-        waiterList.pop_front();
-        waitingTcs.erase(tc);
     }
 
-    if (waiterList.empty())
-        erase(it);
-
     return woken_up;
 }
 
@@ -89,16 +165,22 @@ void
 FutexMap::suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
                int bitmask)
 {
-    FutexKey key(addr, tgid);
-    auto it = find(key);
+    WaiterState &w = waiter(tc);
+    // A context halted while waiting (e.g. by exit_group) and reused since
+    // is still linked into its old queue.
+    if (w.queue)
+        w.queue->remove(&w);
 
-    if (it == end()) {
-        WaiterList waiterList {WaiterState(tc, bitmask)};
-        insert({key, waiterList});
-    } else {
-        it->second.push_back(WaiterState(tc, bitmask));
-    }
-    waitingTcs.emplace(tc);
+    WaitQueue &queue =
+        queues.try_emplace(FutexKey(addr, tgid), addr).first->second;
+
+    stats.waits++;
+    stats.queueLength.sample(queue.size);
+    stats.waitsPerAddr.sample(addr);
+
+    w.bitmask = bitmask;
+    w.waitTick = curTick();
+    queue.push(&w);
 
     /** Suspend the thread context */
     tc->suspend();
@@ -107,76 +189,57 @@ FutexMap::suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
 int
 FutexMap::wakeup_bitset(Addr addr, uint64_t tgid, int bitmask)
 {
-    FutexKey key(addr, tgid);
-    auto it = find(key);
-
-    if (it == end())
+    WaitQueue *queue = findQueue(addr, tgid);
+    if (!queue || queue->empty()) {
+        stats.emptyWakes++;
         return 0;
+    }
 
     int woken_up = 0;
 
-    auto &waiterList = it->second;
-    auto iter = waiterList.begin();
-
-    while (iter != waiterList.end()) {
-        WaiterState& waiter = *iter;
-
-        if (waiter.checkMask(bitmask)) {
-            waiter.tc->activate();
-            waitingTcs.erase(waiter.tc);
-            iter = waiterList.erase(iter);
+    WaiterState *w = queue->head;
+    while (w) {
+        WaiterState *next = w->next;
+        if (w->checkMask(bitmask)) {
+            wake(w);
             woken_up++;
-        } else {
-            ++iter;
         }
+        w = next;
     }
 
-    if (waiterList.empty())
-        erase(it);
-
     return woken_up;
 }
 
 int
 FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
 {
-    FutexKey key1(addr1, tgid);
-    auto it1 = find(key1);
-
-    if (it1 == end())
+    WaitQueue *queue1 = findQueue(addr1, tgid);
+    if (!queue1 || queue1->empty()) {
+        stats.emptyWakes++;
         return 0;
+    }
 
     int woken_up = 0;
-    auto &waiterList1 = it1->second;
 
-    while (!waiterList1.empty() && woken_up < count) {
-        waiterList1.front().tc->activate();
-        waiterList1.pop_front();
+    while (!queue1->empty() && woken_up < count) {
+        wake(queue1->head);
         woken_up++;
     }
 
-    WaiterList tmpList;
-    int requeued = 0;
-
-    while (!waiterList1.empty() && requeued < count2) {
-      auto w = waiterList1.front();
-      waiterList1.pop_front();
-      tmpList.push_back(w);
-      requeued++;
-    }
+    if (queue1->empty() || count2 <= 0 || addr1 == addr2)
+        return woken_up;
 
-    FutexKey key2(addr2, tgid);
-    auto it2 = find(key2);
+    WaitQueue &queue2 =
+        queues.try_emplace(FutexKey(addr2, tgid), addr2).first->second;
+    int requeued = 0;
 
-    if (it2 == end() && requeued > 0) {
-        insert({key2, tmpList});
-    } else {
-        it2->second.insert(it2->second.end(),
-                           tmpList.begin(), tmpList.end());
+    while (!queue1->empty() && requeued < count2) {
+        WaiterState *w = queue1->head;
+        queue1->remove(w);
+        queue2.push(w);
+        requeued++;
     }
-
-    if (waiterList1.empty())
-        erase(it1);
+    stats.requeues += requeued;
 
     return woken_up + requeued;
 }
@@ -184,7 +247,37 @@ FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
 bool
 FutexMap::is_waiting(ThreadContext *tc)
 {
-    return waitingTcs.find(tc) != waitingTcs.end();
+    ContextID id = tc->contextId();
+    return id < (ContextID)waiters.size() && waiters[id].queue;
+}
+
+void
+FutexMap::migrate(ThreadContext *from, ThreadContext *to)
+{
+    WaiterState &old_w = waiter(from);
+    WaiterState &new_w = waiter(to);
+    assert(old_w.queue);
+    // The new context may still be linked from a wait cut short by a halt
+    if (new_w.queue)
+        new_w.queue->remove(&new_w);
+
+    WaitQueue *queue = old_w.queue;
+    new_w.bitmask = old_w.bitmask;
+    new_w.waitTick = old_w.waitTick;
+    new_w.queue = queue;
+    new_w.prev = old_w.prev;
+    new_w.next = old_w.next;
+    if (new_w.prev)
+        new_w.prev->next = &new_w;
+    else
+        queue->head = &new_w;
+    if (new_w.next)
+        new_w.next->prev = &new_w;
+    else
+        queue->tail = &new_w;
+
+    old_w.queue = nullptr;
+    old_w.prev = old_w.next = nullptr;
 }
 
 } // namespace gem5
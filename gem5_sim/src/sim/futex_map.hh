@@ -29,9 +29,10 @@
 #ifndef __FUTEX_MAP_HH__
 #define __FUTEX_MAP_HH__
 
+#include <deque>
 #include <unordered_map>
-#include <unordered_set>
 
+#include <base/statistics.hh>
 #include <cpu/thread_context.hh>
 
 namespace gem5
@@ -79,20 +80,26 @@ namespace std
 namespace gem5
 {
 
+class WaitQueue;
+
 /**
  * WaiterState defines internal state of a waiter thread. The state
  * includes a pointer to the thread's context and its associated bitmask.
+ * A thread waits on at most one futex at a time, so every thread context
+ * owns exactly one WaiterState, which doubles as the node of an intrusive
+ * wait queue. Waiting and waking therefore never allocate.
  */
 class WaiterState
 {
   public:
-    ThreadContext* tc;
-    int bitmask;
+    ThreadContext* tc = nullptr;
+    int bitmask = 0;
+    Tick waitTick = 0;
 
-    /**
-     * this constructor is used if futex ops with bitset are used
-     */
-    WaiterState(ThreadContext* _tc, int _bitmask);
+    /** Queue this thread waits in, nullptr if it is not waiting */
+    WaitQueue *queue = nullptr;
+    WaiterState *prev = nullptr;
+    WaiterState *next = nullptr;
 
     /**
      * return true if the bit-wise AND of the wakeup_bitmask given by
@@ -101,14 +108,36 @@ class WaiterState
     bool checkMask(int wakeup_bitmask) const;
 };
 
-typedef std::list<WaiterState> WaiterList;
+/**
+ * FIFO of the threads waiting on one futex, linked through their
+ * WaiterStates.
+ */
+class WaitQueue
+{
+  public:
+    Addr addr;
+    WaiterState *head = nullptr;
+    WaiterState *tail = nullptr;
+    int size = 0;
+
+    WaitQueue(Addr addr_in) : addr(addr_in) {}
+
+    bool empty() const { return head == nullptr; }
+
+    void push(WaiterState *w);
+    void remove(WaiterState *w);
+};
 
 /**
- * FutexMap class holds a map of all futexes used in the system
+ * FutexMap class holds the wait queues of all futexes used in the system.
+ * Queues are kept once created, so a futex that is waited on again reuses
+ * its queue without touching the hash map.
  */
-class FutexMap : public std::unordered_map<FutexKey, WaiterList>
+class FutexMap
 {
   public:
+    FutexMap(statistics::Group *parent);
+
     /** Inserts a futex into the map with one waiting TC */
     void suspend(Addr addr, uint64_t tgid, ThreadContext *tc);
 
@@ -138,9 +167,42 @@ class FutexMap : public std::unordered_map<FutexKey, WaiterList>
      */
     bool is_waiting(ThreadContext *tc);
 
+    /**
+     * Hands the wait of a thread that moves from one context to another
+     * over to the new context, keeping its place in the queue.
+     */
+    void migrate(ThreadContext *from, ThreadContext *to);
+
   private:
 
-    std::unordered_set<ThreadContext *> waitingTcs;
+    /** Returns the queue of a futex, nullptr if it was never waited on */
+    WaitQueue *findQueue(Addr addr, uint64_t tgid);
+
+    WaiterState &waiter(ThreadContext *tc);
+
+    /** Removes a waiter from its queue and activates its thread */
+    void wake(WaiterState *w);
+
+    std::unordered_map<FutexKey, WaitQueue> queues;
+
+    /**
+     * WaiterStates indexed by context id. A deque keeps them in place when
+     * it grows, since queues link to them.
+     */
+    std::deque<WaiterState> waiters;
+
+    struct FutexStats : public statistics::Group
+    {
+        FutexStats(statistics::Group *parent);
+
+        statistics::Scalar waits;
+        statistics::Scalar wakeups;
+        statistics::Scalar requeues;
+        statistics::Scalar emptyWakes;
+        statistics::Distribution queueLength;
+        statistics::SparseHistogram waitsPerAddr;
+        statistics::SparseHistogram waitTicksPerAddr;
+    } stats;
 };
 
 } // namespace gem5
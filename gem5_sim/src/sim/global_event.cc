@@ -36,6 +36,17 @@ namespace gem5
 
 std::mutex BaseGlobalEvent::globalQMutex;
 
+static std::mutex quantumBarrierMutex;
+static std::vector<std::function<void()>> quantumBarrierCallbacks;
+
+void
+atNextQuantumBarrier(std::function<void()> callback)
+{
+    assert(inParallelMode);
+    std::lock_guard<std::mutex> lock(quantumBarrierMutex);
+    quantumBarrierCallbacks.push_back(std::move(callback));
+}
+
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
     : barrier(numMainEventQueues),
       barrierEvent(numMainEventQueues, NULL)
@@ -152,11 +163,19 @@ GlobalSyncEvent::BarrierEvent::process()
     // to finish before continuing
     globalBarrier();
     curEventQueue()->handleAsyncInsertions();
+    curEventQueue()->processSyncCallbacks();
 }
 
 void
 GlobalSyncEvent::process()
 {
+    // All other threads wait at the barrier, so nothing registers
+    // callbacks while they run
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(quantumBarrierCallbacks);
+    for (auto &callback : callbacks)
+        callback();
+
     if (repeat) {
         schedule(curTick() + repeat);
     }
@@ -30,6 +30,7 @@
 #ifndef __SIM_GLOBAL_EVENT_HH__
 #define __SIM_GLOBAL_EVENT_HH__
 
+#include <functional>
 #include <mutex>
 #include <vector>
 
@@ -240,6 +241,16 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     Tick repeat;
 };
 
+/**
+ * Run a function at the next quantum barrier of a multi-queue
+ * simulation, on one thread while the threads of all other queues wait
+ * at the same tick. Decisions that depend on the state of objects on
+ * several queues are only deterministic there. Functions registered for
+ * the same barrier run in no particular order. May be called from any
+ * thread, but only while the queues run in parallel.
+ */
+void atNextQuantumBarrier(std::function<void()> callback);
+
 } // namespace gem5
 
 #endif // __SIM_GLOBAL_EVENT_HH__
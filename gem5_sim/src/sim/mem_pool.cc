@@ -31,6 +31,8 @@
 
 #include "sim/mem_pool.hh"
 
+#include <cassert>
+
 #include "base/addr_range.hh"
 #include "base/logging.hh"
 
@@ -159,28 +161,77 @@ MemPools::populate(const AddrRangeList &memories)
         pools.emplace_back(pageShift, mem.start(), mem.end());
 }
 
+void
+MemPools::partition(int num_slices)
+{
+    panic_if(num_slices < 1, "Cannot split memory pools into %d slices.",
+             num_slices);
+
+    std::vector<MemPool> whole;
+    whole.swap(pools);
+    for (const auto &mem : whole) {
+        panic_if(mem.allocatedPages(), "Memory pool at %#x was partitioned "
+                 "after pages were allocated from it.", mem.startAddr());
+        // Slice 0 also gets the remainder, all of a memory that has
+        // fewer pages than slices
+        const Counter slice_pages = mem.totalPages() / num_slices;
+        Counter page = mem.startPage();
+        for (int i = 0; i < num_slices; i++) {
+            const Counter pages = i == 0 ?
+                mem.totalPages() - (num_slices - 1) * slice_pages :
+                slice_pages;
+            pools.emplace_back(pageShift, page << pageShift,
+                               (page + pages) << pageShift);
+            page += pages;
+        }
+    }
+    slices = num_slices;
+}
+
+MemPool &
+MemPools::pool(int pool_id, int slice)
+{
+    assert(slice >= 0 && slice < slices);
+    return pools[pool_id * slices + slice];
+}
+
+const MemPool &
+MemPools::pool(int pool_id, int slice) const
+{
+    assert(slice >= 0 && slice < slices);
+    return pools[pool_id * slices + slice];
+}
+
 Addr
-MemPools::allocPhysPages(int npages, int pool_id)
+MemPools::allocPhysPages(int npages, int pool_id, int slice)
 {
-    return pools[pool_id].allocate(npages);
+    return pool(pool_id, slice).allocate(npages);
 }
 
 void
 MemPools::deallocPhysPages(Addr page_addr, int npages, int pool_id)
 {
-    pools[pool_id].deallocate(page_addr, npages);
+    for (int i = 0; i < slices; i++) {
+        MemPool &slice = pool(pool_id, i);
+        if (page_addr >= slice.startAddr() &&
+                page_addr - slice.startAddr() < slice.totalBytes()) {
+            slice.deallocate(page_addr, npages);
+            return;
+        }
+    }
+    panic("Page %#x does not belong to memory pool %d.", page_addr, pool_id);
 }
 
 Addr
-MemPools::memSize(int pool_id) const
+MemPools::memSize(int pool_id, int slice) const
 {
-    return pools[pool_id].totalBytes();
+    return pool(pool_id, slice).totalBytes();
 }
 
 Addr
-MemPools::freeMemSize(int pool_id) const
+MemPools::freeMemSize(int pool_id, int slice) const
 {
-    return pools[pool_id].freeBytes();
+    return pool(pool_id, slice).freeBytes();
 }
 
 void
@@ -189,6 +240,8 @@ MemPools::serialize(CheckpointOut &cp) const
     ScopedCheckpointSection sec(cp, "mempools");
     int num_pools = pools.size();
     SERIALIZE_SCALAR(num_pools);
+    int num_slices = slices;
+    SERIALIZE_SCALAR(num_slices);
 
     for (int i = 0; i < num_pools; i++)
         pools[i].serializeSection(cp, csprintf("pool%d", i));
@@ -203,6 +256,9 @@ MemPools::unserialize(CheckpointIn &cp)
     ScopedCheckpointSection sec(cp, "mempools");
     int num_pools = 0;
     UNSERIALIZE_SCALAR(num_pools);
+    int num_slices = 1;
+    UNSERIALIZE_OPT_SCALAR(num_slices);
+    slices = num_slices;
 
     for (int i = 0; i < num_pools; i++) {
         MemPool pool;
@@ -86,26 +86,45 @@ class MemPools : public Serializable
   private:
     Addr pageShift;
 
+    /** Number of slices every memory is split into, see partition(). */
+    int slices = 1;
+
+    /** The slices of memory i are pools[i * slices .. i * slices + slices). */
     std::vector<MemPool> pools;
 
+    MemPool &pool(int pool_id, int slice);
+    const MemPool &pool(int pool_id, int slice) const;
+
   public:
     MemPools(Addr page_shift) : pageShift(page_shift) {}
 
     void populate(const AddrRangeList &memories);
 
+    /**
+     * Split every memory into num_slices equal slices with separate
+     * free lists, so that threads which only allocate from their own
+     * slice neither share state nor depend on each other's timing.
+     * Slice 0 also gets the pages left over by the division. Must be
+     * called before the first page is allocated.
+     */
+    void partition(int num_slices);
+
+    int numSlices() const { return slices; }
+
     /// Allocate npages contiguous unused physical pages.
     /// @return Starting address of first page
-    Addr allocPhysPages(int npages, int pool_id=0);
+    Addr allocPhysPages(int npages, int pool_id=0, int slice=0);
 
     /// Deallocate physical pages. These may be reallocated by
-    /// allocPhysPages later on.
+    /// allocPhysPages later on. They go back to the slice they
+    /// were allocated from.
     void deallocPhysPages(Addr page_addr, int npages, int pool_id=0);
 
-    /** Amount of physical memory that exists in a pool. */
-    Addr memSize(int pool_id=0) const;
+    /** Amount of physical memory that exists in a pool slice. */
+    Addr memSize(int pool_id=0, int slice=0) const;
 
-    /** Amount of physical memory that is still free in a pool. */
-    Addr freeMemSize(int pool_id=0) const;
+    /** Amount of physical memory that is still free in a pool slice. */
+    Addr freeMemSize(int pool_id=0, int slice=0) const;
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
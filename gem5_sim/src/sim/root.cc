@@ -43,6 +43,7 @@
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
+#include "mem/packet_pool.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
@@ -193,6 +194,13 @@ Root::Root(const RootParams &p, int)
     // having a single global stat group for global stats. Merge that
     // group into the root object here.
     mergeStatGroup(&Root::RootStats::instance);
+
+    setEventQueueScheduler(
+        p.eventq_scheduler == EventQueueScheduler::calendar ?
+        EventQueue::Scheduler::Calendar : EventQueue::Scheduler::List);
+
+    packet_pool::setEnabled(p.packet_pool);
+    addStatGroup("packetPool", &packet_pool::stats());
 }
 
 void
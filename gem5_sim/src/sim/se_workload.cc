@@ -27,8 +27,10 @@
 
 #include "sim/se_workload.hh"
 
+#include "base/logging.hh"
 #include "cpu/thread_context.hh"
 #include "params/SEWorkload.hh"
+#include "sim/eventq.hh"
 #include "sim/process.hh"
 #include "sim/system.hh"
 
@@ -53,6 +55,34 @@ SEWorkload::setSystem(System *sys)
     memPools.populate(memories);
 }
 
+void
+SEWorkload::init()
+{
+    Workload::init();
+
+    // Every object has picked its event queue by now, and processes
+    // allocate their first pages in initState()
+    if (numMainEventQueues > 1)
+        memPools.partition(numMainEventQueues);
+}
+
+int
+SEWorkload::currentSlice() const
+{
+    if (memPools.numSlices() == 1 || !inParallelMode)
+        return 0;
+
+    for (int i = 0; i < int(numMainEventQueues); i++) {
+        if (mainEventQueue[i] == curEventQueue()) {
+            fatal_if(i >= memPools.numSlices(), "Event queue %d has no "
+                     "memory pool slice, the checkpoint was taken with %d "
+                     "event queues.", i, memPools.numSlices());
+            return i;
+        }
+    }
+    panic("The current event queue is not a main event queue.");
+}
+
 void
 SEWorkload::serialize(CheckpointOut &cp) const
 {
@@ -74,7 +104,7 @@ SEWorkload::syscall(ThreadContext *tc)
 Addr
 SEWorkload::allocPhysPages(int npages, int pool_id)
 {
-    return memPools.allocPhysPages(npages, pool_id);
+    return memPools.allocPhysPages(npages, pool_id, currentSlice());
 }
 
 void
@@ -86,13 +116,13 @@ SEWorkload::deallocPhysPage(Addr paddr, int pool_id)
 Addr
 SEWorkload::memSize(int pool_id) const
 {
-    return memPools.memSize(pool_id);
+    return memPools.memSize(pool_id, currentSlice());
 }
 
 Addr
 SEWorkload::freeMemSize(int pool_id) const
 {
-    return memPools.freeMemSize(pool_id);
+    return memPools.freeMemSize(pool_id, currentSlice());
 }
 
 } // namespace gem5
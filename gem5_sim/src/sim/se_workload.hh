@@ -41,6 +41,14 @@ class SEWorkload : public Workload
     /** Memory allocation objects for all physical memories in the system. */
     MemPools memPools;
 
+    /**
+     * The memory pool slice of the calling thread. Event queues running
+     * in parallel each allocate from their own slice, so page faults and
+     * syscalls on different host threads neither race nor make physical
+     * addresses depend on host timing. Serial code uses slice 0.
+     */
+    int currentSlice() const;
+
   public:
     using Params = SEWorkloadParams;
 
@@ -48,6 +56,8 @@ class SEWorkload : public Workload
 
     void setSystem(System *sys) override;
 
+    void init() override;
+
     Addr
     getEntry() const override
     {
@@ -91,6 +101,8 @@ class SEWorkload : public Workload
 
     Addr allocPhysPages(int npages, int pool_id=0);
     void deallocPhysPage(Addr paddr, int pool_id=0);
+
+    /** Size and free memory of the caller's slice of a pool. */
     Addr memSize(int pool_id=0) const;
     Addr freeMemSize(int pool_id=0) const;
 };
@@ -295,6 +295,7 @@ doSimLoop(EventQueue *eventq)
     // set the per thread current eventq pointer
     curEventQueue(eventq);
     eventq->handleAsyncInsertions();
+    eventq->processSyncCallbacks();
 
     bool mainQueue = eventq == getEventQueue(0);
 
@@ -29,6 +29,8 @@
 
 #include "sim/syscall_desc.hh"
 
+#include <mutex>
+
 #include "base/types.hh"
 #include "sim/eventq.hh"
 #include "sim/syscall_debug_macros.hh"
@@ -38,11 +40,39 @@ namespace gem5
 
 class ThreadContext;
 
+namespace
+{
+
+// Syscalls of threads on different event queues share the System and the
+// futex map, and may free pages of the serial memory pool slice, so they
+// run one at a time while the queues run in parallel. Pages are allocated
+// from the slice of the caller's queue (see SEWorkload::currentSlice()),
+// so page faults need no lock.
+std::mutex parallelSyscallMutex;
+
+std::unique_lock<std::mutex>
+lockParallelSyscalls()
+{
+    std::unique_lock<std::mutex> lock(parallelSyscallMutex, std::defer_lock);
+    if (!inParallelMode || lock.try_lock())
+        return lock;
+
+    // The holder may be migrating into this queue for a functional
+    // access, e.g. through a ThreadBridge, so never wait for it while
+    // holding the queue's service lock.
+    EventQueue::ScopedRelease release(curEventQueue());
+    lock.lock();
+    return lock;
+}
+
+} // anonymous namespace
+
 void
 SyscallDesc::doSyscall(ThreadContext *tc)
 {
     DPRINTF_SYSCALL(Base, "Calling %s...\n", dumper(name(), tc));
 
+    auto lock = lockParallelSyscalls();
     SyscallReturn retval = executor(this, tc);
 
     if (retval.needsRetry()) {
@@ -62,6 +92,7 @@ SyscallDesc::retrySyscall(ThreadContext *tc)
 {
     DPRINTF_SYSCALL(Base, "Retrying %s...\n", dumper(name(), tc));
 
+    auto lock = lockParallelSyscalls();
     SyscallReturn retval = executor(this, tc);
 
     if (retval.needsRetry()) {
@@ -57,6 +57,7 @@
 #include "mem/page_table.hh"
 #include "mem/se_translating_port_proxy.hh"
 #include "sim/byteswap.hh"
+#include "sim/global_event.hh"
 #include "sim/process.hh"
 #include "sim/proxy_ptr.hh"
 #include "sim/sim_exit.hh"
@@ -102,12 +103,27 @@ ignoreWarnOnceFunc(SyscallDesc *desc, ThreadContext *tc)
     return 0;
 }
 
+SyscallReturn
+ignoreWithEnosysFunc(SyscallDesc *desc, ThreadContext *tc)
+{
+    static std::unordered_map<SyscallDesc *, bool> bool_map;
+
+    bool &warned = bool_map[desc];
+    if (!warned) {
+        warn("ignoring syscall %s(...), returning ENOSYS\n"
+             "      (further warnings will be suppressed)", desc->name());
+        warned = true;
+    }
+
+    return -ENOSYS;
+}
+
 static void
 exitFutexWake(ThreadContext *tc, VPtr<> addr, uint64_t tgid)
 {
     // Clear value at address pointed to by thread's childClearTID field.
-    BufferArg ctidBuf(addr, sizeof(long));
-    long *ctid = (long *)ctidBuf.bufferPtr();
+    BufferArg ctidBuf(addr, sizeof(int32_t));
+    int32_t *ctid = (int32_t *)ctidBuf.bufferPtr();
     *ctid = 0;
     ctidBuf.copyOut(SETranslatingPortProxy(tc));
 
@@ -116,6 +132,61 @@ exitFutexWake(ThreadContext *tc, VPtr<> addr, uint64_t tgid)
     futex_map.wakeup(addr, tgid, 1);
 }
 
+namespace
+{
+
+/**
+ * Exit of the last thread context while the event queues run in
+ * parallel. Threads on other queues may still be running earlier ticks
+ * in host time, so whether a context is the last one is decided at the
+ * next quantum barrier. The exit status is the one of the latest exit
+ * in simulated time, ties broken by pid, as in a serial run.
+ */
+struct ParallelExit
+{
+    bool pending = false;
+    Tick when = 0;
+    uint64_t pid = 0;
+    int status = 0;
+};
+
+ParallelExit parallelExit;
+
+void
+checkParallelExit(System *sys)
+{
+    int status = parallelExit.status;
+    parallelExit = ParallelExit();
+
+    int activeContexts = 0;
+    for (auto &system: sys->systemList)
+        activeContexts += system->threads.numRunning();
+
+    if (activeContexts == 0 && DistIface::readyToExit(0))
+        exitSimLoop("exiting with last active thread context", status & 0xff);
+}
+
+void
+deferParallelExit(System *sys, Process *p, int status)
+{
+    // Syscalls are serialized while the queues run in parallel, see
+    // SyscallDesc::doSyscall()
+    if (!parallelExit.pending) {
+        parallelExit.pending = true;
+        atNextQuantumBarrier([sys]() { checkParallelExit(sys); });
+    } else if (curTick() < parallelExit.when ||
+               (curTick() == parallelExit.when &&
+                p->pid() < parallelExit.pid)) {
+        return;
+    }
+
+    parallelExit.when = curTick();
+    parallelExit.pid = p->pid();
+    parallelExit.status = status;
+}
+
+} // anonymous namespace
+
 static SyscallReturn
 exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
 {
@@ -218,6 +289,11 @@ exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
 
     tc->halt();
 
+    if (inParallelMode) {
+        deferParallelExit(sys, p, status);
+        return status;
+    }
+
     /**
      * check to see if there is no more active thread in the system. If so,
      * exit the simulation loop
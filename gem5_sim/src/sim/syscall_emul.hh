@@ -140,6 +140,10 @@ SyscallReturn ignoreFunc(SyscallDesc *desc, ThreadContext *tc);
 /// Like above, but only prints a warning once per syscall desc it's used with.
 SyscallReturn
 ignoreWarnOnceFunc(SyscallDesc *desc, ThreadContext *tc);
+/// Like ignoreFunc, but fails with ENOSYS so that the target program falls
+/// back to its code path for kernels without the syscall (e.g. rseq).
+SyscallReturn
+ignoreWithEnosysFunc(SyscallDesc *desc, ThreadContext *tc);
 
 /// Target exit() handler: terminate current context.
 SyscallReturn exitFunc(SyscallDesc *desc, ThreadContext *tc, int status);
@@ -1765,11 +1769,13 @@ doClone(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
         return -EINVAL;
 
     ThreadContext *ctc;
-    if (!(ctc = tc->getSystemPtr()->threads.findFree())) {
+    if (!(ctc = tc->getSystemPtr()->placeThread(tc))) {
         DPRINTF_SYSCALL(Verbose, "clone: no spare thread context in system"
                         "[cpu %d, thread %d]", tc->cpuId(), tc->threadId());
         return -EAGAIN;
     }
+    DPRINTF(SyscallVerbose, "clone: placing the new thread on context %d\n",
+            ctc->contextId());
 
     /**
      * Note that ProcessParams is generated by swig and there are no other
@@ -1815,9 +1821,10 @@ doClone(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
     owner->revokeThreadContext(ctc->contextId());
 
     if (flags & OS::TGT_CLONE_PARENT_SETTID) {
-        BufferArg ptidBuf(ptidPtr, sizeof(long));
-        long *ptid = (long *)ptidBuf.bufferPtr();
-        *ptid = cp->pid();
+        // pid_t is 32 bits wide on every Linux ABI
+        BufferArg ptidBuf(ptidPtr, sizeof(int32_t));
+        int32_t *ptid = (int32_t *)ptidBuf.bufferPtr();
+        *ptid = htog((int32_t)cp->pid(), OS::byteOrder);
         ptidBuf.copyOut(SETranslatingPortProxy(tc));
     }
 
@@ -1839,9 +1846,9 @@ doClone(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
     }
 
     if (flags & OS::TGT_CLONE_CHILD_SETTID) {
-        BufferArg ctidBuf(ctidPtr, sizeof(long));
-        long *ctid = (long *)ctidBuf.bufferPtr();
-        *ctid = cp->pid();
+        BufferArg ctidBuf(ctidPtr, sizeof(int32_t));
+        int32_t *ctid = (int32_t *)ctidBuf.bufferPtr();
+        *ctid = htog((int32_t)cp->pid(), OS::byteOrder);
         ctidBuf.copyOut(SETranslatingPortProxy(ctc));
     }
 
@@ -3019,23 +3026,79 @@ schedGetaffinityFunc(SyscallDesc *desc, ThreadContext *tc,
                      VPtr<> cpu_set_mask)
 {
 #if defined(__linux__)
-    if (cpusetsize < CPU_ALLOC_SIZE(tc->getSystemPtr()->threads.size()))
+    System *sys = tc->getSystemPtr();
+    if (cpusetsize < CPU_ALLOC_SIZE(sys->threads.size()))
         return -EINVAL;
 
+    ThreadContext *target = pid ? sys->findThread(pid) : tc;
+    if (!target)
+        return -ESRCH;
+
     SETranslatingPortProxy proxy(tc);
     BufferArg maskBuf(cpu_set_mask, cpusetsize);
-    maskBuf.copyIn(proxy);
-    for (int i = 0; i < tc->getSystemPtr()->threads.size(); i++) {
-        CPU_SET(i, (cpu_set_t *)maskBuf.bufferPtr());
+    CPU_ZERO_S(cpusetsize, (cpu_set_t *)maskBuf.bufferPtr());
+    for (int i = 0; i < sys->threads.size(); i++) {
+        if (sys->hartAllowed(target->contextId(), i))
+            CPU_SET(i, (cpu_set_t *)maskBuf.bufferPtr());
     }
     maskBuf.copyOut(proxy);
-    return CPU_ALLOC_SIZE(tc->getSystemPtr()->threads.size());
+    return CPU_ALLOC_SIZE(sys->threads.size());
 #else
     warnUnsupportedOS("sched_getaffinity");
     return -1;
 #endif
 }
 
+/// Target sched_setaffinity handler. The mask restricts the harts that
+/// placeThread() may pick for the threads the target thread clones. Another
+/// thread that sits outside its new mask moves to an allowed halted hart if
+/// it has not run since clone or waits on a futex; see
+/// System::migrateThread(). Any other thread stays where it is.
+template <class OS>
+SyscallReturn
+schedSetaffinityFunc(SyscallDesc *desc, ThreadContext *tc,
+                     pid_t pid, typename OS::size_t cpusetsize,
+                     VPtr<> cpu_set_mask)
+{
+    System *sys = tc->getSystemPtr();
+    ThreadContext *target = pid ? sys->findThread(pid) : tc;
+    if (!target)
+        return -ESRCH;
+
+    BufferArg maskBuf(cpu_set_mask, cpusetsize);
+    maskBuf.copyIn(SETranslatingPortProxy(tc));
+    // cpu_set_t is an array of target longs; on little endian targets
+    // hart i is bit i % 8 of byte i / 8.
+    const uint8_t *bytes = (const uint8_t *)maskBuf.bufferPtr();
+    std::vector<bool> mask(sys->threads.size(), false);
+    bool any = false;
+    for (int i = 0; i < sys->threads.size() && i / 8 < cpusetsize; i++) {
+        mask[i] = bytes[i / 8] & (1 << (i % 8));
+        any = any || mask[i];
+    }
+    if (!any)
+        return -EINVAL;
+
+    sys->setAffinity(target->contextId(), std::move(mask));
+
+    // The calling thread is in the middle of this syscall and cannot move
+    if (target != tc) {
+        ThreadContext *moved = sys->migrateThread(target);
+        if (moved != target) {
+            DPRINTF_SYSCALL(Verbose, "sched_setaffinity: moved the thread "
+                            "from context %d to context %d\n",
+                            target->contextId(), moved->contextId());
+            target = moved;
+        }
+    }
+
+    warn_if(!sys->hartAllowed(target->contextId(), target->contextId()),
+            "sched_setaffinity: the thread on hart %d stays outside its new "
+            "mask, which only applies to the threads it creates.",
+            target->contextId());
+    return 0;
+}
+
 // Target recvfrom() handler.
 template <class OS>
 SyscallReturn
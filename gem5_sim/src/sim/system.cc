@@ -59,8 +59,10 @@
 #include "params/System.hh"
 #include "sim/byteswap.hh"
 #include "sim/debug.hh"
+#include "sim/process.hh"
 #include "sim/redirect_path.hh"
 #include "sim/serialize_handlers.hh"
+#include "sim/stat_control.hh"
 
 namespace gem5
 {
@@ -179,10 +181,12 @@ System::System(const Params &p)
       memoryMode(p.mem_mode),
       _cacheLineSize(p.cache_line_size),
       numWorkIds(p.num_work_ids),
+      roiStats(this),
       thermalModel(p.thermal_model),
       _m5opRange(p.m5ops_base ?
                  RangeSize(p.m5ops_base, 0x10000) :
                  AddrRange(1, 0)), // Create an empty range if disabled
+      futexMap(this),
       redirectPaths(p.redirect_paths)
 {
     panic_if(!workload, "No workload set for system %s "
@@ -403,6 +407,267 @@ System::workItemEnd(uint32_t tid, uint32_t workid)
     lastWorkItemStarted.erase(p);
 }
 
+void
+System::roiBegin(ThreadContext *tc)
+{
+    ContextID id = tc->contextId();
+    if (id >= (ContextID)roiEnterTick.size()) {
+        roiEnterTick.resize(id + 1, MaxTick);
+        roiEntered.resize(id + 1, false);
+    }
+    if (roiEnterTick[id] != MaxTick) {
+        warn_once("Nested work_begin on context %d ignored for the ROI.\n",
+                  id);
+        return;
+    }
+
+    if (!roiOpen) {
+        DPRINTF(WorkItems, "ROI opens on context %d\n", id);
+        roiOpen = true;
+        roiStartTick = curTick();
+        roiNumEntered = 0;
+        std::fill(roiEntered.begin(), roiEntered.end(), false);
+        if (params().roi_stats)
+            statistics::schedStatEvent(false, true);
+    }
+
+    roiEnterTick[id] = curTick();
+    roiInside++;
+    if (!roiEntered[id]) {
+        roiEntered[id] = true;
+        roiNumEntered++;
+    }
+}
+
+void
+System::roiEnd(ThreadContext *tc)
+{
+    ContextID id = tc->contextId();
+    if (id >= (ContextID)roiEnterTick.size() || roiEnterTick[id] == MaxTick)
+        return;
+
+    Tick work = curTick() - roiEnterTick[id];
+    roiEnterTick[id] = MaxTick;
+    roiInside--;
+    if (id < (ContextID)roiStats.threadTicks.size()) {
+        roiStats.threadTicks[id] += work;
+        roiStats.threadCycles[id] += tc->getCpuPtr()->ticksToCycles(work);
+    }
+
+    if (roiInside > 0 || roiNumEntered < params().roi_threads)
+        return;
+
+    DPRINTF(WorkItems, "ROI closes on context %d after %d ticks, %d harts\n",
+            id, curTick() - roiStartTick, roiNumEntered);
+    roiOpen = false;
+    roiStats.count++;
+    roiStats.ticks += curTick() - roiStartTick;
+    if (params().roi_stats)
+        statistics::schedStatEvent(true, false);
+}
+
+ThreadContext *
+System::placeThread(ThreadContext *parent)
+{
+    const ContextID num_harts = threads.size();
+    const ContextID pid = parent->contextId();
+
+    // Running queues in parallel, a hart on another event queue belongs
+    // to another host thread, so the new thread stays in the parent's.
+    EventQueue *parent_queue = parent->getCpuPtr()->eventQueue();
+    auto free = [&](ContextID hart) {
+        return threads[hart]->status() == ThreadContext::Halted &&
+               hartAllowed(pid, hart) &&
+               (!inParallelMode ||
+                threads[hart]->getCpuPtr()->eventQueue() == parent_queue);
+    };
+
+    ContextID hart = InvalidContextID;
+    switch (params().thread_placement) {
+      case SEThreadPlacement::first_free:
+        for (ContextID i = 0; i < num_harts && hart < 0; i++) {
+            if (free(i))
+                hart = i;
+        }
+        break;
+      case SEThreadPlacement::round_robin:
+        for (ContextID i = 1; i <= num_harts && hart < 0; i++) {
+            if (free((lastPlaced + i) % num_harts))
+                hart = (lastPlaced + i) % num_harts;
+        }
+        break;
+      case SEThreadPlacement::cluster:
+        {
+            ContextID size = params().harts_per_cluster ?
+                params().harts_per_cluster : num_harts;
+            // Stay in the parent's cluster while it has a free hart,
+            // otherwise spread to the cluster with the most free harts.
+            int best_free = 0;
+            for (ContextID base = 0; base < num_harts; base += size) {
+                ContextID first = InvalidContextID;
+                int num_free = 0;
+                for (ContextID i = base;
+                     i < std::min(base + size, num_harts); i++) {
+                    if (free(i)) {
+                        if (first < 0)
+                            first = i;
+                        num_free++;
+                    }
+                }
+                if (first >= 0 && pid / size == base / size) {
+                    hart = first;
+                    break;
+                }
+                if (num_free > best_free) {
+                    best_free = num_free;
+                    hart = first;
+                }
+            }
+        }
+        break;
+      default:
+        panic("Unknown thread placement policy.");
+    }
+
+    if (hart < 0)
+        return nullptr;
+
+    lastPlaced = hart;
+    setAffinity(hart,
+                pid < (ContextID)threadAffinity.size() ?
+                threadAffinity[pid] : std::vector<bool>());
+    if (hart >= (ContextID)placedInsts.size())
+        placedInsts.resize(hart + 1, -1);
+    placedInsts[hart] = threads[hart]->getCpuPtr()->totalInsts();
+    return threads[hart];
+}
+
+bool
+System::hartAllowed(ContextID id, ContextID hart) const
+{
+    if (id >= (ContextID)threadAffinity.size() ||
+            threadAffinity[id].empty()) {
+        return true;
+    }
+    return hart < (ContextID)threadAffinity[id].size() &&
+           threadAffinity[id][hart];
+}
+
+void
+System::setAffinity(ContextID id, std::vector<bool> mask)
+{
+    if (id >= (ContextID)threadAffinity.size())
+        threadAffinity.resize(id + 1);
+    threadAffinity[id] = std::move(mask);
+}
+
+ThreadContext *
+System::migrateThread(ThreadContext *tc)
+{
+    const ContextID from = tc->contextId();
+    if (hartAllowed(from, from))
+        return tc;
+
+    // The architectural state is copied, so nothing of the thread may be
+    // in a pipeline: it has not run since clone or it sleeps on a futex.
+    bool fresh = from < (ContextID)placedInsts.size() &&
+        placedInsts[from] == tc->getCpuPtr()->totalInsts();
+    bool waiting = tc->status() == ThreadContext::Suspended &&
+        futexMap.is_waiting(tc);
+    // The ROI accounts time per hart
+    bool in_roi = from < (ContextID)roiEnterTick.size() &&
+        roiEnterTick[from] != MaxTick;
+    EventQueue *queue = tc->getCpuPtr()->eventQueue();
+    if (!(fresh || waiting) || in_roi ||
+            (inParallelMode && queue != curEventQueue())) {
+        return tc;
+    }
+
+    ContextID to = InvalidContextID;
+    for (ContextID i = 0; i < (ContextID)threads.size() && to < 0; i++) {
+        if (threads[i]->status() == ThreadContext::Halted &&
+                hartAllowed(from, i) &&
+                threads[i]->getCpuPtr()->eventQueue() == queue) {
+            to = i;
+        }
+    }
+    if (to < 0)
+        return tc;
+
+    ThreadContext *ntc = threads[to];
+    Process *p = tc->getProcessPtr();
+    Process *owner = ntc->getProcessPtr();
+    ntc->setProcessPtr(p);
+    p->assignThreadContext(to);
+    owner->revokeThreadContext(to);
+    ntc->setUseForClone(tc->getUseForClone());
+    ntc->copyArchRegs(tc);
+
+    setAffinity(to, std::move(threadAffinity[from]));
+    setAffinity(from, std::vector<bool>());
+    if (to >= (ContextID)placedInsts.size())
+        placedInsts.resize(to + 1, -1);
+    placedInsts[to] = fresh ? ntc->getCpuPtr()->totalInsts() : -1;
+    placedInsts[from] = -1;
+
+    if (waiting) {
+        futexMap.migrate(tc, ntc);
+        ntc->suspend();
+    } else {
+        ntc->activate();
+    }
+    tc->halt();
+    return ntc;
+}
+
+ThreadContext *
+System::findThread(uint64_t pid) const
+{
+    for (auto *tc: threads) {
+        if (tc->status() != ThreadContext::Halted &&
+                tc->getProcessPtr() && tc->getProcessPtr()->pid() == pid) {
+            return tc;
+        }
+    }
+    return nullptr;
+}
+
+System::RoiStats::RoiStats(System *sys)
+    : statistics::Group(sys, "roi"),
+      system(sys),
+      ADD_STAT(count, statistics::units::Count::get(),
+               "Number of closed regions of interest"),
+      ADD_STAT(ticks, statistics::units::Tick::get(),
+               "Ticks from the first work_begin to the last work_end"),
+      ADD_STAT(threadTicks, statistics::units::Tick::get(),
+               "Ticks each hart spent between work_begin and work_end"),
+      ADD_STAT(threadCycles, statistics::units::Cycle::get(),
+               "Cycles each hart spent between work_begin and work_end"),
+      ADD_STAT(threadWaitTicks, statistics::units::Tick::get(),
+               "Ticks each hart spent in the ROI outside its work item"),
+      ADD_STAT(threadUtilization, statistics::units::Ratio::get(),
+               "Fraction of the ROI each hart spent in its work item"),
+      ADD_STAT(parallelism, statistics::units::Ratio::get(),
+               "Average number of harts inside their work item")
+{
+    threadWaitTicks = ticks - threadTicks;
+    threadUtilization = threadTicks / ticks;
+    parallelism = sum(threadTicks) / ticks;
+}
+
+void
+System::RoiStats::regStats()
+{
+    statistics::Group::regStats();
+
+    // Thread contexts are registered in BaseCPU::init(), before regStats()
+    size_t harts = std::max<size_t>(1, system->threads.size());
+    threadTicks.init(harts).flags(statistics::nozero);
+    threadCycles.init(harts).flags(statistics::nozero);
+    threadWaitTicks.flags(statistics::nozero);
+    threadUtilization.flags(statistics::nozero);
+}
+
 bool
 System::trapToGdb(GDBSignal signal, ContextID ctx_id) const
 {
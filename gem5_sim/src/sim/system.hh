@@ -416,6 +416,49 @@ class System : public SimObject, public PCEventScope
     uint64_t workItemsEnd = 0;
     uint32_t numWorkIds;
 
+    /** Tick at which each hart entered the ROI, MaxTick when outside. */
+    std::vector<Tick> roiEnterTick;
+    /** Harts that entered the ROI since it opened. */
+    std::vector<bool> roiEntered;
+    int roiInside = 0;
+    int roiNumEntered = 0;
+    bool roiOpen = false;
+    Tick roiStartTick = 0;
+
+    /** Affinity mask of the thread on each context, empty if any hart */
+    std::vector<std::vector<bool>> threadAffinity;
+    /** Hart of the last thread placed by placeThread() */
+    ContextID lastPlaced = 0;
+    /**
+     * Instructions the CPU of each hart had committed when placeThread()
+     * picked it, -1 for harts that were not placed. A thread has not run
+     * since it was cloned while its CPU's count has not moved.
+     */
+    std::vector<Counter> placedInsts;
+
+    struct RoiStats : public statistics::Group
+    {
+        RoiStats(System *sys);
+
+        void regStats() override;
+
+        System *system;
+
+        /** Number of closed ROIs */
+        statistics::Scalar count;
+        /** Ticks from the first work_begin to the last work_end */
+        statistics::Scalar ticks;
+        /** Ticks each hart spent between its work_begin and work_end */
+        statistics::Vector threadTicks;
+        /** The same time in cycles of the hart's CPU */
+        statistics::Vector threadCycles;
+        /** Ticks each hart spent in the ROI outside its work item */
+        statistics::Formula threadWaitTicks;
+        statistics::Formula threadUtilization;
+        /** Average number of harts inside the ROI */
+        statistics::Formula parallelism;
+    } roiStats;
+
     /** This array is a per-system list of all devices capable of issuing a
      * memory system request and an associated string for each requestor id.
      * It's used to uniquely id any requestor in the system by name for things
@@ -555,6 +598,43 @@ class System : public SimObject, public PCEventScope
 
     void workItemEnd(uint32_t tid, uint32_t workid);
 
+    /**
+     * Called by pseudo_inst to track the region of interest per hart. A hart
+     * enters the ROI with work_begin and leaves it with work_end. The ROI
+     * opens at the first work_begin and closes once no hart is inside and
+     * at least roi_threads harts have entered it. With roi_stats set, the
+     * statistics are reset when the ROI opens and dumped when it closes.
+     */
+    void roiBegin(ThreadContext *tc);
+    void roiEnd(ThreadContext *tc);
+
+    /**
+     * Picks a free hart for a thread cloned by parent in SE mode, following
+     * thread_placement and the parent's affinity. The new thread inherits
+     * that affinity. When event queues run in parallel, only harts on the
+     * parent's queue are considered. Returns nullptr if no allowed hart
+     * is free.
+     */
+    ThreadContext *placeThread(ThreadContext *parent);
+
+    /** Whether the thread on context id may run on the given hart */
+    bool hartAllowed(ContextID id, ContextID hart) const;
+
+    /** Restricts the thread on context id to the harts set in mask */
+    void setAffinity(ContextID id, std::vector<bool> mask);
+
+    /**
+     * Moves the thread on tc to a halted hart its affinity allows if tc
+     * is outside it. Only a thread whose state is not in flight is moved:
+     * one that has not run since it was cloned or that waits on a futex,
+     * outside the ROI and on the current event queue. Returns the context
+     * the thread is on afterwards.
+     */
+    ThreadContext *migrateThread(ThreadContext *tc);
+
+    /** Returns the live SE thread with the given pid, nullptr if none */
+    ThreadContext *findThread(uint64_t pid) const;
+
     /* Returns whether we successfully trapped into GDB. */
     bool trapToGdb(GDBSignal signal, ContextID ctx_id) const;
 
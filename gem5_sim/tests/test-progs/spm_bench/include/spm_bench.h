@@ -0,0 +1,245 @@
+/*
+ * SPM compute/DMA overlap benchmark harness
+ *
+ * A kernel is split into tiles. Each tile is loaded from the L2 SPM into an
+ * L1D SPM buffer by IDMA channel 0, computed from the input buffer into an
+ * output buffer, and stored back to the L2 SPM by IDMA channel 1.
+ *
+ * run_kernel() runs the kernel twice:
+ *   serial:  load, wait, compute, store, wait for every tile
+ *   overlap: ping-pong buffers, tile t+1 is loaded and tile t-1 is stored
+ *            while tile t is computed
+ * and reports cycles and bytes per cycle for both. Around each run it
+ * resets and dumps the gem5 statistics with m5 ops and brackets the run
+ * with m5_work_begin/m5_work_end, so stats.txt holds one dump per run.
+ */
+
+#ifndef SPM_BENCH_H
+#define SPM_BENCH_H
+
+#include "mini_libc.h"
+
+// ============================================================================
+// Memory Map
+// ============================================================================
+
+#define L1D_SPM_BASE    0x80010000UL
+#define L2_SPM_BASE     0x80020000UL
+#define IDMA_BASE       0x80060000UL
+
+// L1D 中的 ping-pong 缓冲区，每个 8KB
+#define BUF_SIZE        (8 * 1024)
+#define IN_BUF(i)       (L1D_SPM_BASE + (i) * BUF_SIZE)
+#define OUT_BUF(i)      (L1D_SPM_BASE + (2 + (i)) * BUF_SIZE)
+
+// L2 低 64KB 留给 .data，数据集放在其后
+#define L2_DATA         (L2_SPM_BASE + 0x10000)
+#define L2_DATA_SIZE    (192 * 1024)
+
+// MMR Registers
+#define DMA_INT_STATUS  (IDMA_BASE + 0x14)
+#define DMA_INT_ENABLE  (IDMA_BASE + 0x18)
+#define DMA_CH_DESC_HEAD(ch) (IDMA_BASE + 0x100 + (ch) * 0x20)
+#define DMA_INT_CH(ch)  (0x2 << (ch))
+#define DMA_DESC_LAST   0x1
+
+#define LOAD_CH         0
+#define STORE_CH        1
+#define MAX_DESCS       4
+
+// ============================================================================
+// m5 ops (see include/gem5/asm/generic/m5ops.h)
+// ============================================================================
+
+// RISC-V 伪指令：opcode 0x7b，bit 31:25 为功能号。RV32 上 64 位参数占用
+// 一对寄存器 (a0/a1, a2/a3)
+#define M5OP(func, a, b) do {                                          \
+        register uint32_t _a0 asm("a0") = (uint32_t)(a);               \
+        register uint32_t _a1 asm("a1") = 0;                           \
+        register uint32_t _a2 asm("a2") = (uint32_t)(b);               \
+        register uint32_t _a3 asm("a3") = 0;                           \
+        asm volatile (".word 0x7b | (" #func " << 25)"                 \
+                      : "+r"(_a0)                                      \
+                      : "r"(_a1), "r"(_a2), "r"(_a3) : "memory");      \
+    } while (0)
+
+#define m5_reset_stats()            M5OP(0x40, 0, 0)
+#define m5_dump_reset_stats()       M5OP(0x42, 0, 0)
+#define m5_work_begin(id, thread)   M5OP(0x5a, id, thread)
+#define m5_work_end(id, thread)     M5OP(0x5b, id, thread)
+
+static inline uint32_t rdcycle(void) {
+    uint32_t cycles;
+    asm volatile ("rdcycle %0" : "=r"(cycles));
+    return cycles;
+}
+
+// ============================================================================
+// IDMA descriptors
+// ============================================================================
+
+// IDMA descriptor, must match gem5::IDMA::Descriptor (48 bytes)
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t length;            // bytes per row
+    uint32_t next;              // next descriptor, 0 ends the chain
+    uint32_t src_stride;        // 2D row stride
+    uint32_t dst_stride;
+    uint32_t num_rows;          // 0 is treated as 1
+    uint32_t src_plane_stride;  // 3D plane stride
+    uint32_t dst_plane_stride;
+    uint32_t num_planes;        // 0 is treated as 1
+    uint32_t flags;
+    uint32_t reserved;
+} dma_desc_t;
+
+// Fill a 2D descriptor: rows rows of len bytes. Use rows = 1 for 1D.
+static void desc_2d(dma_desc_t *d, uint32_t src, uint32_t dst, uint32_t len,
+                    uint32_t rows, uint32_t src_stride, uint32_t dst_stride) {
+    memset(d, 0, sizeof(*d));
+    d->src = src;
+    d->dst = dst;
+    d->length = len;
+    d->num_rows = rows;
+    d->src_stride = src_stride;
+    d->dst_stride = dst_stride;
+}
+
+static void desc_1d(dma_desc_t *d, uint32_t src, uint32_t dst, uint32_t len) {
+    desc_2d(d, src, dst, len, 1, 0, 0);
+}
+
+// ============================================================================
+// Kernel description
+// ============================================================================
+
+typedef struct {
+    const char *name;
+    int num_tiles;
+    // DMA 字节数（每块的读入加写回），用于计算带宽
+    uint32_t bytes_per_tile;
+    // 在 L2 中准备输入数据，每次运行前调用
+    void (*setup)(void);
+    // 填写第 tile 块的读入/写回描述符，返回描述符个数 (<= MAX_DESCS)
+    int (*load)(int tile, uint32_t in_buf, dma_desc_t *d);
+    int (*store)(int tile, uint32_t out_buf, dma_desc_t *d);
+    void (*compute)(int tile, uint32_t in_buf, uint32_t out_buf);
+    // 对 L2 中的结果求校验和，两种模式的结果应当相同
+    uint32_t (*checksum)(void);
+} kernel_t;
+
+static dma_desc_t load_desc[MAX_DESCS] __attribute__((aligned(16)));
+static dma_desc_t store_desc[MAX_DESCS] __attribute__((aligned(16)));
+static int load_pending;
+static int store_pending;
+
+static void dma_chain(int ch, dma_desc_t *d, int n) {
+    for (int i = 0; i < n; i++) {
+        d[i].next = (i + 1 < n) ? (uint32_t)&d[i + 1] : 0;
+    }
+    d[n - 1].flags |= DMA_DESC_LAST;
+    *(volatile uint32_t*)DMA_CH_DESC_HEAD(ch) = (uint32_t)d;
+}
+
+// Sleep in wfi until the channel's completion bit is pending, then
+// acknowledge it.
+static void dma_ch_wait(int ch, int *pending) {
+    volatile uint32_t *int_status = (volatile uint32_t*)DMA_INT_STATUS;
+    if (!*pending)
+        return;
+    while (!(*int_status & DMA_INT_CH(ch))) {
+        asm volatile ("wfi");
+    }
+    *int_status = DMA_INT_CH(ch);
+    *pending = 0;
+}
+
+static void issue_load(const kernel_t *k, int tile) {
+    dma_chain(LOAD_CH, load_desc, k->load(tile, IN_BUF(tile & 1), load_desc));
+    load_pending = 1;
+}
+
+static void issue_store(const kernel_t *k, int tile) {
+    dma_chain(STORE_CH, store_desc,
+              k->store(tile, OUT_BUF(tile & 1), store_desc));
+    store_pending = 1;
+}
+
+static void run_serial(const kernel_t *k) {
+    for (int t = 0; t < k->num_tiles; t++) {
+        issue_load(k, t);
+        dma_ch_wait(LOAD_CH, &load_pending);
+        k->compute(t, IN_BUF(t & 1), OUT_BUF(t & 1));
+        issue_store(k, t);
+        dma_ch_wait(STORE_CH, &store_pending);
+    }
+}
+
+static void run_overlap(const kernel_t *k) {
+    issue_load(k, 0);
+    for (int t = 0; t < k->num_tiles; t++) {
+        dma_ch_wait(LOAD_CH, &load_pending);
+        // 计算第 t 块时预取第 t+1 块到另一个输入缓冲区
+        if (t + 1 < k->num_tiles)
+            issue_load(k, t + 1);
+        k->compute(t, IN_BUF(t & 1), OUT_BUF(t & 1));
+        // 上一块写回完成后，描述符和输出缓冲区才能复用
+        dma_ch_wait(STORE_CH, &store_pending);
+        issue_store(k, t);
+    }
+    dma_ch_wait(STORE_CH, &store_pending);
+}
+
+// a * 100 / b without 64-bit division, which -nostdlib cannot link
+static uint32_t ratio100(uint32_t a, uint32_t b) {
+    while (a > 0xffffffffu / 100) {
+        a >>= 1;
+        b >>= 1;
+    }
+    return b ? a * 100 / b : 0;
+}
+
+// Print value / 100 with two decimals
+static void put_fixed2(uint32_t value) {
+    uint32_t frac = value % 100;
+    printf("%d.%s%d", value / 100, frac < 10 ? "0" : "", frac);
+}
+
+static uint32_t run_mode(const kernel_t *k, int kernel_id, int overlap) {
+    k->setup();
+
+    m5_reset_stats();
+    m5_work_begin(kernel_id, overlap);
+    uint32_t start = rdcycle();
+    if (overlap)
+        run_overlap(k);
+    else
+        run_serial(k);
+    uint32_t cycles = rdcycle() - start;
+    m5_work_end(kernel_id, overlap);
+    m5_dump_reset_stats();
+
+    uint32_t bytes = k->bytes_per_tile * k->num_tiles;
+    printf("%s %s: %d cycles, %d bytes, ", k->name,
+           overlap ? "overlap" : "serial ", cycles, bytes);
+    put_fixed2(ratio100(bytes, cycles));
+    printf(" B/cycle, checksum 0x%x\n", k->checksum());
+    return cycles;
+}
+
+// Run the kernel serially and overlapped and report the speedup
+static int run_kernel(const kernel_t *k, int kernel_id) {
+    *(volatile uint32_t*)DMA_INT_ENABLE = DMA_INT_CH(LOAD_CH) |
+                                          DMA_INT_CH(STORE_CH);
+
+    uint32_t serial = run_mode(k, kernel_id, 0);
+    uint32_t overlap = run_mode(k, kernel_id, 1);
+
+    printf("%s overlap speedup: ", k->name);
+    put_fixed2(ratio100(serial, overlap));
+    printf("x\n");
+    return 0;
+}
+
+#endif // SPM_BENCH_H
@@ -0,0 +1,90 @@
+/*
+ * 2D convolution: 3x3 int32 filter over a 128x128 int32 image in the L2 SPM.
+ *
+ * The image is stored with one zero row above and below, so each tile of
+ * 8 output rows loads 10 contiguous input rows with one 1D descriptor.
+ * The two border columns are written as zero.
+ */
+
+#include "spm_bench.h"
+
+#define WIDTH       128
+#define HEIGHT      128
+#define TILE_ROWS   8
+#define ROW_BYTES   (WIDTH * 4)
+
+#define IN_L2       (L2_DATA)
+#define OUT_L2      (IN_L2 + (HEIGHT + 2) * ROW_BYTES)
+
+static const int32_t filter[3][3] = {
+    { 1, 2, 1 },
+    { 2, 4, 2 },
+    { 1, 2, 1 },
+};
+
+static void conv_setup(void) {
+    int32_t *img = (int32_t*)IN_L2;
+    memset(img, 0, ROW_BYTES);
+    memset(img + (HEIGHT + 1) * WIDTH, 0, ROW_BYTES);
+    for (int r = 0; r < HEIGHT; r++) {
+        for (int c = 0; c < WIDTH; c++) {
+            img[(r + 1) * WIDTH + c] = (r * 3 + c) & 0xff;
+        }
+    }
+}
+
+static int conv_load(int tile, uint32_t in_buf, dma_desc_t *d) {
+    // 输出第 r 行需要补零后图像的第 r..r+2 行
+    desc_1d(&d[0], IN_L2 + tile * TILE_ROWS * ROW_BYTES, in_buf,
+            (TILE_ROWS + 2) * ROW_BYTES);
+    return 1;
+}
+
+static int conv_store(int tile, uint32_t out_buf, dma_desc_t *d) {
+    desc_1d(&d[0], out_buf, OUT_L2 + tile * TILE_ROWS * ROW_BYTES,
+            TILE_ROWS * ROW_BYTES);
+    return 1;
+}
+
+static void conv_compute(int tile, uint32_t in_buf, uint32_t out_buf) {
+    const int32_t *in = (const int32_t*)in_buf;
+    int32_t *out = (int32_t*)out_buf;
+
+    for (int r = 0; r < TILE_ROWS; r++) {
+        out[r * WIDTH] = 0;
+        for (int c = 1; c < WIDTH - 1; c++) {
+            int32_t sum = 0;
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    sum += filter[i][j] * in[(r + i) * WIDTH + c + j - 1];
+                }
+            }
+            out[r * WIDTH + c] = sum;
+        }
+        out[r * WIDTH + WIDTH - 1] = 0;
+    }
+}
+
+static uint32_t conv_checksum(void) {
+    const uint32_t *out = (const uint32_t*)OUT_L2;
+    uint32_t sum = 0;
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+        sum = sum * 31 + out[i];
+    }
+    return sum;
+}
+
+static const kernel_t conv_kernel = {
+    .name = "conv2d",
+    .num_tiles = HEIGHT / TILE_ROWS,
+    .bytes_per_tile = (2 * TILE_ROWS + 2) * ROW_BYTES,
+    .setup = conv_setup,
+    .load = conv_load,
+    .store = conv_store,
+    .compute = conv_compute,
+    .checksum = conv_checksum,
+};
+
+int main() {
+    return run_kernel(&conv_kernel, 1);
+}
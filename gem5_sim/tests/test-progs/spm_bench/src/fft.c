@@ -0,0 +1,129 @@
+/*
+ * Batched FFT: 32 independent 256-point complex fixed-point FFTs.
+ *
+ * Each FFT holds 256 (re, im) int32 pairs in Q15, 2KB, in the L2 SPM. A tile
+ * loads 4 FFTs, copies them into the output buffer in bit-reversed order,
+ * runs the radix-2 butterflies there and stores the result back in place.
+ * Every stage halves the values so that they cannot overflow.
+ */
+
+#include "spm_bench.h"
+
+#define POINTS          256
+#define LOG2_POINTS     8
+#define NUM_FFTS        32
+#define FFTS_PER_TILE   4
+#define FFT_BYTES       (POINTS * 2 * 4)
+
+#define DATA_L2         (L2_DATA)
+
+// sin(2 * pi * k / 256) in Q15 for k = 0..64
+static const int32_t sin_table[POINTS / 4 + 1] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739,
+    9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151,
+    16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683,
+    28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678,
+    32728, 32757, 32767,
+};
+
+// 由四分之一周期的正弦表得到 0..POINTS/2 的旋转因子
+static int32_t twiddle_sin(int k) {
+    return k <= POINTS / 4 ? sin_table[k] : sin_table[POINTS / 2 - k];
+}
+
+static int32_t twiddle_cos(int k) {
+    return k <= POINTS / 4 ? sin_table[POINTS / 4 - k]
+                           : -sin_table[k - POINTS / 4];
+}
+
+static uint32_t bit_reverse(uint32_t x) {
+    uint32_t r = 0;
+    for (int i = 0; i < LOG2_POINTS; i++) {
+        r = (r << 1) | (x & 1);
+        x >>= 1;
+    }
+    return r;
+}
+
+static void fft_setup(void) {
+    int32_t *data = (int32_t*)DATA_L2;
+    for (int i = 0; i < NUM_FFTS * POINTS; i++) {
+        data[2 * i] = ((i * 37) & 0x3fff) - 0x2000;
+        data[2 * i + 1] = 0;
+    }
+}
+
+static int fft_load(int tile, uint32_t in_buf, dma_desc_t *d) {
+    desc_1d(&d[0], DATA_L2 + tile * FFTS_PER_TILE * FFT_BYTES, in_buf,
+            FFTS_PER_TILE * FFT_BYTES);
+    return 1;
+}
+
+static int fft_store(int tile, uint32_t out_buf, dma_desc_t *d) {
+    desc_1d(&d[0], out_buf, DATA_L2 + tile * FFTS_PER_TILE * FFT_BYTES,
+            FFTS_PER_TILE * FFT_BYTES);
+    return 1;
+}
+
+static void fft_one(const int32_t *in, int32_t *x) {
+    for (int i = 0; i < POINTS; i++) {
+        uint32_t j = bit_reverse(i);
+        x[2 * j] = in[2 * i];
+        x[2 * j + 1] = in[2 * i + 1];
+    }
+
+    for (int len = 2; len <= POINTS; len <<= 1) {
+        int half = len / 2;
+        int step = POINTS / len;
+        for (int base = 0; base < POINTS; base += len) {
+            for (int k = 0; k < half; k++) {
+                int32_t wr = twiddle_cos(k * step);
+                int32_t wi = -twiddle_sin(k * step);
+                int32_t *u = &x[2 * (base + k)];
+                int32_t *v = &x[2 * (base + k + half)];
+
+                int32_t tr = (v[0] * wr - v[1] * wi) >> 15;
+                int32_t ti = (v[0] * wi + v[1] * wr) >> 15;
+                int32_t ur = u[0];
+                int32_t ui = u[1];
+                u[0] = (ur + tr) >> 1;
+                u[1] = (ui + ti) >> 1;
+                v[0] = (ur - tr) >> 1;
+                v[1] = (ui - ti) >> 1;
+            }
+        }
+    }
+}
+
+static void fft_compute(int tile, uint32_t in_buf, uint32_t out_buf) {
+    for (int f = 0; f < FFTS_PER_TILE; f++) {
+        fft_one((const int32_t*)(in_buf + f * FFT_BYTES),
+                (int32_t*)(out_buf + f * FFT_BYTES));
+    }
+}
+
+static uint32_t fft_checksum(void) {
+    const uint32_t *data = (const uint32_t*)DATA_L2;
+    uint32_t sum = 0;
+    for (int i = 0; i < NUM_FFTS * POINTS * 2; i++) {
+        sum = sum * 31 + data[i];
+    }
+    return sum;
+}
+
+static const kernel_t fft_kernel = {
+    .name = "fft",
+    .num_tiles = NUM_FFTS / FFTS_PER_TILE,
+    .bytes_per_tile = 2 * FFTS_PER_TILE * FFT_BYTES,
+    .setup = fft_setup,
+    .load = fft_load,
+    .store = fft_store,
+    .compute = fft_compute,
+    .checksum = fft_checksum,
+};
+
+int main() {
+    return run_kernel(&fft_kernel, 2);
+}
@@ -0,0 +1,89 @@
+/*
+ * Tiled GEMM: C = A * B, 64x64 int32 matrices in the L2 SPM.
+ *
+ * Each tile computes a 16x16 block of C from a 16x64 row block of A
+ * (one 1D descriptor) and a 64x16 column block of B (one 2D descriptor).
+ * The C block is stored back with a 2D descriptor.
+ */
+
+#include "spm_bench.h"
+
+#define DIM     64
+#define TILE    16
+#define TILES_PER_ROW (DIM / TILE)
+
+#define A_L2    (L2_DATA)
+#define B_L2    (A_L2 + DIM * DIM * 4)
+#define C_L2    (B_L2 + DIM * DIM * 4)
+
+#define ROW_BYTES   (DIM * 4)
+#define TILE_BYTES  (TILE * 4)
+
+static void gemm_setup(void) {
+    int32_t *a = (int32_t*)A_L2;
+    int32_t *b = (int32_t*)B_L2;
+    for (int i = 0; i < DIM * DIM; i++) {
+        a[i] = (i % 7) - 3;
+        b[i] = (i % 5) - 2;
+    }
+}
+
+static int gemm_load(int tile, uint32_t in_buf, dma_desc_t *d) {
+    int bi = tile / TILES_PER_ROW;
+    int bj = tile % TILES_PER_ROW;
+
+    // A 的 16 行连续存放；B 的 16 列按行跨步取出，在 L1D 中紧密排列
+    desc_1d(&d[0], A_L2 + bi * TILE * ROW_BYTES, in_buf, TILE * ROW_BYTES);
+    desc_2d(&d[1], B_L2 + bj * TILE_BYTES, in_buf + TILE * ROW_BYTES,
+            TILE_BYTES, DIM, ROW_BYTES, TILE_BYTES);
+    return 2;
+}
+
+static int gemm_store(int tile, uint32_t out_buf, dma_desc_t *d) {
+    int bi = tile / TILES_PER_ROW;
+    int bj = tile % TILES_PER_ROW;
+
+    desc_2d(&d[0], out_buf, C_L2 + bi * TILE * ROW_BYTES + bj * TILE_BYTES,
+            TILE_BYTES, TILE, TILE_BYTES, ROW_BYTES);
+    return 1;
+}
+
+static void gemm_compute(int tile, uint32_t in_buf, uint32_t out_buf) {
+    const int32_t *a = (const int32_t*)in_buf;                  // TILE x DIM
+    const int32_t *b = (const int32_t*)(in_buf + TILE * ROW_BYTES); // DIM x TILE
+    int32_t *c = (int32_t*)out_buf;                             // TILE x TILE
+
+    for (int i = 0; i < TILE; i++) {
+        for (int j = 0; j < TILE; j++) {
+            int32_t sum = 0;
+            for (int k = 0; k < DIM; k++) {
+                sum += a[i * DIM + k] * b[k * TILE + j];
+            }
+            c[i * TILE + j] = sum;
+        }
+    }
+}
+
+static uint32_t gemm_checksum(void) {
+    const uint32_t *c = (const uint32_t*)C_L2;
+    uint32_t sum = 0;
+    for (int i = 0; i < DIM * DIM; i++) {
+        sum = sum * 31 + c[i];
+    }
+    return sum;
+}
+
+static const kernel_t gemm_kernel = {
+    .name = "gemm",
+    .num_tiles = TILES_PER_ROW * TILES_PER_ROW,
+    .bytes_per_tile = 2 * TILE * ROW_BYTES + TILE * TILE_BYTES,
+    .setup = gemm_setup,
+    .load = gemm_load,
+    .store = gemm_store,
+    .compute = gemm_compute,
+    .checksum = gemm_checksum,
+};
+
+int main() {
+    return run_kernel(&gemm_kernel, 0);
+}
@@ -0,0 +1,72 @@
+/*
+ * STREAM triad: a[i] = b[i] + SCALAR * c[i] over 8192 int32 elements.
+ *
+ * Each tile loads 1024 elements of b and c with a two-descriptor chain and
+ * stores 1024 elements of a. The kernel does little compute per byte, so it
+ * shows how much of the DMA time the ping-pong buffers can hide.
+ */
+
+#include "spm_bench.h"
+
+#define N           8192
+#define TILE        1024
+#define TILE_BYTES  (TILE * 4)
+#define SCALAR      3
+
+#define A_L2        (L2_DATA)
+#define B_L2        (A_L2 + N * 4)
+#define C_L2        (B_L2 + N * 4)
+
+static void triad_setup(void) {
+    int32_t *b = (int32_t*)B_L2;
+    int32_t *c = (int32_t*)C_L2;
+    for (int i = 0; i < N; i++) {
+        b[i] = i;
+        c[i] = N - i;
+    }
+}
+
+static int triad_load(int tile, uint32_t in_buf, dma_desc_t *d) {
+    desc_1d(&d[0], B_L2 + tile * TILE_BYTES, in_buf, TILE_BYTES);
+    desc_1d(&d[1], C_L2 + tile * TILE_BYTES, in_buf + TILE_BYTES, TILE_BYTES);
+    return 2;
+}
+
+static int triad_store(int tile, uint32_t out_buf, dma_desc_t *d) {
+    desc_1d(&d[0], out_buf, A_L2 + tile * TILE_BYTES, TILE_BYTES);
+    return 1;
+}
+
+static void triad_compute(int tile, uint32_t in_buf, uint32_t out_buf) {
+    const int32_t *b = (const int32_t*)in_buf;
+    const int32_t *c = (const int32_t*)(in_buf + TILE_BYTES);
+    int32_t *a = (int32_t*)out_buf;
+
+    for (int i = 0; i < TILE; i++) {
+        a[i] = b[i] + SCALAR * c[i];
+    }
+}
+
+static uint32_t triad_checksum(void) {
+    const uint32_t *a = (const uint32_t*)A_L2;
+    uint32_t sum = 0;
+    for (int i = 0; i < N; i++) {
+        sum = sum * 31 + a[i];
+    }
+    return sum;
+}
+
+static const kernel_t triad_kernel = {
+    .name = "triad",
+    .num_tiles = N / TILE,
+    .bytes_per_tile = 3 * TILE_BYTES,
+    .setup = triad_setup,
+    .load = triad_load,
+    .store = triad_store,
+    .compute = triad_compute,
+    .checksum = triad_checksum,
+};
+
+int main() {
+    return run_kernel(&triad_kernel, 3);
+}
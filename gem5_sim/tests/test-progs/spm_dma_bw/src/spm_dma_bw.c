@@ -0,0 +1,87 @@
+/*
+ * SPM DMA Bandwidth Benchmark
+ *
+ * Copies BUF_SIZE bytes between every pair of L1I, L1D and L2 SPM with the
+ * IDMA single-transfer registers and prints the achieved bandwidth:
+ *
+ *   bw <src>-><dst> <bytes> <cycles>
+ *
+ * configs/spm/dma_sweep.py runs this program for every burst size and
+ * outstanding-burst setting and collects these lines.
+ */
+
+#include "mini_libc.h"
+
+// ============================================================================
+// Memory Map
+// ============================================================================
+
+#define L1I_SPM_BASE    0x80000000UL
+#define L1D_SPM_BASE    0x80010000UL
+#define L2_SPM_BASE     0x80020000UL
+#define IDMA_BASE       0x80060000UL
+
+// 缓冲区避开 L1I 低端的代码和 L2 低端的 .data
+#define L1I_BUF         (L1I_SPM_BASE + 0x8000)
+#define L1D_BUF         (L1D_SPM_BASE)
+#define L2_BUF          (L2_SPM_BASE + 0x10000)
+
+#define BUF_SIZE        (8 * 1024)
+#define REPEAT          4
+
+// MMR Registers
+#define DMA_SRC_ADDR    (IDMA_BASE + 0x00)
+#define DMA_DST_ADDR    (IDMA_BASE + 0x04)
+#define DMA_SIZE        (IDMA_BASE + 0x08)
+#define DMA_CMD         (IDMA_BASE + 0x0C)
+#define DMA_INT_STATUS  (IDMA_BASE + 0x14)
+#define DMA_INT_ENABLE  (IDMA_BASE + 0x18)
+
+#define DMA_INT_LEGACY  0x1
+
+static inline uint32_t rdcycle(void) {
+    uint32_t cycles;
+    asm volatile ("rdcycle %0" : "=r"(cycles));
+    return cycles;
+}
+
+// Copy size bytes and sleep in wfi until the completion interrupt
+static void dma_copy(uint32_t src, uint32_t dst, uint32_t size) {
+    volatile uint32_t *int_status = (volatile uint32_t*)DMA_INT_STATUS;
+
+    *(volatile uint32_t*)DMA_SRC_ADDR = src;
+    *(volatile uint32_t*)DMA_DST_ADDR = dst;
+    *(volatile uint32_t*)DMA_SIZE = size;
+    *(volatile uint32_t*)DMA_CMD = 1;
+
+    while (!(*int_status & DMA_INT_LEGACY)) {
+        asm volatile ("wfi");
+    }
+    *int_status = DMA_INT_LEGACY;
+}
+
+static void measure(const char *name, uint32_t src, uint32_t dst) {
+    // 先拷贝一次，把 IDMA 的 IOTLB 预热
+    dma_copy(src, dst, BUF_SIZE);
+
+    uint32_t start = rdcycle();
+    for (int i = 0; i < REPEAT; i++) {
+        dma_copy(src, dst, BUF_SIZE);
+    }
+    uint32_t cycles = rdcycle() - start;
+
+    printf("bw %s %d %d\n", name, BUF_SIZE * REPEAT, cycles);
+}
+
+int main() {
+    *(volatile uint32_t*)DMA_INT_ENABLE = DMA_INT_LEGACY;
+
+    measure("l1i->l1d", L1I_BUF, L1D_BUF);
+    measure("l1d->l1i", L1D_BUF, L1I_BUF);
+    measure("l1d->l2", L1D_BUF, L2_BUF);
+    measure("l2->l1d", L2_BUF, L1D_BUF);
+    measure("l1i->l2", L1I_BUF, L2_BUF);
+    measure("l2->l1i", L2_BUF, L1I_BUF);
+
+    return 0;
+}